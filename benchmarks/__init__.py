@@ -0,0 +1,144 @@
+# -*- coding: UTF-8 -*-
+#
+# Copyright 2010-2013 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+"""Performance benchmarks for the hot paths of pygit2.
+
+Run with::
+
+    python setup.py bench
+
+Synthetic fixtures are built in a temporary directory; their sizes can
+be multiplied with the PYGIT2_BENCH_SCALE environment variable (default
+1) to stress bigger repositories.
+"""
+
+from __future__ import print_function
+from __future__ import unicode_literals
+
+import os
+import shutil
+import tempfile
+from timeit import default_timer
+
+import pygit2
+
+
+SCALE = int(os.getenv('PYGIT2_BENCH_SCALE', '1'))
+
+COMMITS = 200 * SCALE
+STATUS_FILES = 1000 * SCALE
+BLOB_SIZES = [100, 10 * 1024, 1024 * 1024]
+
+SIGNATURE = pygit2.Signature('Benchmark', 'bench@example.com', 0, 0)
+
+
+def build_history(path):
+    """A linear history of COMMITS commits, one file change each."""
+    repo = pygit2.init_repository(path, False)
+    parents = []
+    for i in range(COMMITS):
+        name = 'file-%d.txt' % (i % 10)
+        with open(os.path.join(path, name), 'w') as f:
+            f.write('content %d\n' % i)
+        repo.index.add(name)
+        tree = repo.index.write_tree()
+        oid = repo.create_commit('HEAD', SIGNATURE, SIGNATURE,
+                                 'commit %d' % i, tree, parents)
+        parents = [oid.hex]
+    return repo
+
+
+def build_worktree(path):
+    """A committed worktree with STATUS_FILES files in nested dirs."""
+    repo = pygit2.init_repository(path, False)
+    paths = []
+    for i in range(STATUS_FILES):
+        subdir = os.path.join(path, 'dir-%d' % (i % 100))
+        if not os.path.isdir(subdir):
+            os.mkdir(subdir)
+        name = os.path.join('dir-%d' % (i % 100), 'file-%d.txt' % i)
+        with open(os.path.join(path, name), 'w') as f:
+            f.write('content %d\n' % i)
+        paths.append(name)
+    repo.index.add_many(paths)
+    tree = repo.index.write_tree()
+    repo.create_commit('HEAD', SIGNATURE, SIGNATURE, 'initial', tree, [])
+    return repo
+
+
+def bench(name, func, number):
+    start = default_timer()
+    for i in range(number):
+        func()
+    elapsed = default_timer() - start
+    ops = number / elapsed if elapsed else float('inf')
+    print('%-40s %12.1f ops/sec  (%d runs in %.3fs)'
+          % (name, ops, number, elapsed))
+
+
+def run():
+    tmp = tempfile.mkdtemp(prefix='pygit2-bench-')
+    try:
+        history = build_history(os.path.join(tmp, 'history'))
+        worktree = build_worktree(os.path.join(tmp, 'worktree'))
+
+        head = history.head.target
+        tail = next(iter(history.walk(head, pygit2.GIT_SORT_REVERSE))).oid
+
+        def walk():
+            for commit in history.walk(head, pygit2.GIT_SORT_TIME):
+                pass
+
+        def diff():
+            history[head].tree.diff_to_tree(history[tail].tree)
+
+        def status():
+            worktree.status()
+
+        blobs = [history.create_blob(b'x' * size) for size in BLOB_SIZES]
+
+        def read_raw():
+            for oid in blobs:
+                history.read(oid)
+
+        bench('walk %d commits' % COMMITS, walk, 10)
+        bench('diff_to_tree', diff, 100)
+        bench('status %d files' % STATUS_FILES, status, 10)
+        bench('read_raw blobs %s' % BLOB_SIZES, read_raw, 100)
+
+        try:
+            import resource
+            rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+            print('peak RSS: %d kB' % rss)
+        except ImportError:
+            pass
+    finally:
+        shutil.rmtree(tmp)
+
+
+if __name__ == '__main__':
+    run()
@@ -33,6 +33,8 @@ import _pygit2
 from _pygit2 import *
 
 # High level API
+from .commit_graph import CommitGraph
+from .jobs import Job, submit
 from .repository import Repository
 from .version import __version__
 
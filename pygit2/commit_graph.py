@@ -0,0 +1,199 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright 2010-2013 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+"""
+A serialized commit graph for fast history queries.
+
+Walking a big repository with Repository.walk() parses every commit out
+of the object database before the first result is yielded. The
+CommitGraph here is built once from the commit headers (no trees or
+blobs are touched), can be saved next to the repository, and answers
+time-sorted and topologically-sorted walks without opening the object
+database at all.
+"""
+
+# Import from the future
+from __future__ import absolute_import
+from __future__ import unicode_literals
+
+import heapq
+import pickle
+
+# Import from pygit2
+from _pygit2 import (GIT_SORT_NONE, GIT_SORT_TIME, GIT_SORT_TOPOLOGICAL,
+                     GIT_SORT_REVERSE)
+
+
+# Bumped whenever the serialized layout changes
+FORMAT_VERSION = 1
+
+
+class CommitGraph(object):
+    """An immutable snapshot of the commit graph.
+
+    Maps every reachable commit hex to its parent hexes, commit time and
+    generation number (1 + the longest path to a root commit).
+    """
+
+    def __init__(self, parents, times, generations):
+        self._parents = parents
+        self._times = times
+        self._generations = generations
+
+    def __len__(self):
+        return len(self._parents)
+
+    def __contains__(self, hex):
+        return hex in self._parents
+
+    def parents(self, hex):
+        """Return the list of parent hexes of the given commit hex."""
+        return list(self._parents[hex])
+
+    def commit_time(self, hex):
+        """Return the commit time of the given commit hex."""
+        return self._times[hex]
+
+    def generation(self, hex):
+        """Return the generation number of the given commit hex.
+
+        Root commits have generation 1; every other commit is one more
+        than the highest generation among its parents.
+        """
+        return self._generations[hex]
+
+    def walk(self, hex, sort_mode=GIT_SORT_NONE):
+        """Generator over the ancestor hexes of the given commit.
+
+        Supports the same sort modes as Repository.walk(), but reads
+        only from the snapshot: commits created after the graph was
+        built are not seen.
+        """
+        reverse = bool(sort_mode & GIT_SORT_REVERSE)
+        sort_mode &= ~GIT_SORT_REVERSE
+
+        if sort_mode == GIT_SORT_TOPOLOGICAL:
+            results = self._walk_topological(hex)
+        else:
+            results = self._walk_time(hex)
+
+        if reverse:
+            results = reversed(list(results))
+        return iter(results)
+
+    def _walk_time(self, hex):
+        # The generation number bounds the commit date of every
+        # ancestor, so a heap keyed on (time, generation) never yields a
+        # commit before its descendants even with skewed clocks.
+        seen = set([hex])
+        heap = [(-self._times[hex], -self._generations[hex], hex)]
+        while heap:
+            _, _, hex = heapq.heappop(heap)
+            yield hex
+            for parent in self._parents[hex]:
+                if parent not in seen:
+                    seen.add(parent)
+                    heapq.heappush(heap, (-self._times[parent],
+                                          -self._generations[parent], parent))
+
+    def _walk_topological(self, hex):
+        # Iterative depth-first post-order, reversed: parents always
+        # come after their children.
+        seen = set([hex])
+        order = []
+        stack = [(hex, iter(self._parents[hex]))]
+        while stack:
+            hex, parents = stack[-1]
+            advanced = False
+            for parent in parents:
+                if parent not in seen:
+                    seen.add(parent)
+                    stack.append((parent, iter(self._parents[parent])))
+                    advanced = True
+                    break
+            if not advanced:
+                stack.pop()
+                order.append(hex)
+        return reversed(order)
+
+    def save(self, path):
+        """Serialize the graph to the given path."""
+        with open(path, 'wb') as f:
+            pickle.dump((FORMAT_VERSION, self._parents, self._times,
+                         self._generations), f, 2)
+
+    @classmethod
+    def load(cls, path):
+        """Load a graph previously written by save().
+
+        Raises ValueError if the file was written by an incompatible
+        version of pygit2.
+        """
+        with open(path, 'rb') as f:
+            data = pickle.load(f)
+        if data[0] != FORMAT_VERSION:
+            raise ValueError('unsupported commit graph version %d' % data[0])
+        return cls(data[1], data[2], data[3])
+
+    @classmethod
+    def build(cls, repository, tips):
+        """Build a graph of everything reachable from the given tips.
+
+        Only commit headers are read, via Commit.parent_ids, so neither
+        trees nor blobs are loaded.
+        """
+        parents = {}
+        times = {}
+
+        pending = [tip.hex if hasattr(tip, 'hex') else tip for tip in tips]
+        while pending:
+            hex = pending.pop()
+            if hex in parents:
+                continue
+            commit = repository[hex]
+            hexes = [oid.hex for oid in commit.parent_ids]
+            parents[hex] = hexes
+            times[hex] = commit.commit_time
+            pending.extend(hexes)
+
+        # Generation numbers, parents before children
+        generations = {}
+        for hex in parents:
+            stack = [hex]
+            while stack:
+                hex = stack[-1]
+                missing = [p for p in parents[hex]
+                           if p not in generations]
+                if missing:
+                    stack.extend(missing)
+                    continue
+                stack.pop()
+                if hex not in generations:
+                    generations[hex] = 1 + max(
+                        [generations[p] for p in parents[hex]] or [0])
+
+        return cls(parents, times, generations)
@@ -0,0 +1,106 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright 2010-2013 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+"""
+Background execution of long-running repository calls.
+
+The heavy entry points of the C extension (checkout, fetch, status,
+pack writing, bulk object reads and writes, ...) release the GIL while
+libgit2 works, so they can truly run in parallel with Python code. The
+Job handle here is the thin glue: submit() starts the call on a
+background thread and the caller polls or waits for the result instead
+of blocking.
+"""
+
+# Import from the future
+from __future__ import absolute_import
+from __future__ import unicode_literals
+
+import threading
+
+try:
+    TimeoutError
+except NameError:
+    # Python 2
+    class TimeoutError(OSError):
+        pass
+
+
+class Job(object):
+    """Handle for a repository call running on a background thread."""
+
+    def __init__(self, function, args, kwargs):
+        self._result = None
+        self._exception = None
+        self._thread = threading.Thread(
+            target=self._run, args=(function, args, kwargs))
+        self._thread.daemon = True
+        self._thread.start()
+
+    def _run(self, function, args, kwargs):
+        try:
+            self._result = function(*args, **kwargs)
+        except BaseException as exception:
+            self._exception = exception
+
+    def done(self):
+        """Return whether the call has finished."""
+        return not self._thread.is_alive()
+
+    def wait(self, timeout=None):
+        """Block until the call finishes, or the timeout (in seconds)
+        expires. Returns whether the call has finished.
+        """
+        self._thread.join(timeout)
+        return self.done()
+
+    def result(self, timeout=None):
+        """Return what the call returned, blocking until it finishes.
+
+        If the call raised, the exception is re-raised here. If a
+        timeout (in seconds) is given and expires first, TimeoutError
+        is raised.
+        """
+        if not self.wait(timeout):
+            raise TimeoutError('job still running')
+        if self._exception is not None:
+            raise self._exception
+        return self._result
+
+
+def submit(function, *args, **kwargs):
+    """Run function(*args, **kwargs) on a background thread.
+
+    Returns a Job handle. Because the long calls of the C extension
+    release the GIL, the submitted work runs in parallel with the
+    calling thread::
+
+        >>> job = submit(repo.checkout_tree, treeish)
+        >>> ...  # do other work
+        >>> job.result()
+    """
+    return Job(function, args, kwargs)
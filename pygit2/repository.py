@@ -95,13 +95,18 @@ class Repository(_Repository):
     #
     # Checkout
     #
-    def checkout(self, refname=None, strategy=GIT_CHECKOUT_SAFE_CREATE):
+    def checkout(self, refname=None, strategy=GIT_CHECKOUT_SAFE_CREATE,
+                 progress=None):
         """
         Checkout the given reference using the given strategy, and update
         the HEAD.
         The reference may be a reference name or a Reference object.
         The default strategy is GIT_CHECKOUT_SAFE_CREATE.
 
+        The optional progress callable is called as
+        progress(path, completed_steps, total_steps) while files are
+        being written out.
+
         To checkout from the HEAD, just pass 'HEAD'::
 
           >>> checkout('HEAD')
@@ -111,11 +116,11 @@ class Repository(_Repository):
         """
         # Case 1: Checkout index
         if refname is None:
-            return self.checkout_index(strategy)
+            return self.checkout_index(strategy, progress)
 
         # Case 2: Checkout head
         if refname == 'HEAD':
-            return self.checkout_head(strategy)
+            return self.checkout_head(strategy, progress)
 
         # Case 3: Reference
         if type(refname) is Reference:
@@ -126,7 +131,7 @@ class Repository(_Repository):
 
         oid = reference.resolve().target
         treeish = self[oid]
-        self.checkout_tree(treeish, strategy)
+        self.checkout_tree(treeish, strategy, progress)
         self.head = refname
 
 
@@ -102,6 +102,28 @@ class TestCommand(Command):
         unittest.main(None, defaultTest='test.test_suite', argv=test_argv)
 
 
+class BenchCommand(Command):
+    """Command for running the benchmarks without install."""
+
+    user_options = []
+
+    def initialize_options(self):
+        pass
+
+    def finalize_options(self):
+        pass
+
+    def run(self):
+        self.run_command('build')
+        bld = self.distribution.get_command_obj('build')
+        # Add build_lib in to sys.path so that the benchmarks pick up the
+        # freshly built extension
+        sys.path = [os.path.abspath(bld.build_lib)] + sys.path
+
+        import benchmarks
+        benchmarks.run()
+
+
 class BuildWithDLLs(build):
 
     # On Windows, we install the git2.dll too.
@@ -158,6 +180,7 @@ class sdist_files_from_git(sdist):
 
 cmdclass = {
     'test': TestCommand,
+    'bench': BenchCommand,
     'sdist': sdist_files_from_git}
 
 if os.name == 'nt':
@@ -43,7 +43,8 @@ Blob_size__get__(Blob *self)
 
 PyDoc_STRVAR(Blob_data__doc__,
   "The contents of the blob, a bytes string. This is the same as\n"
-  "Blob.read_raw()");
+  "Blob.read_raw(). For a zero-copy view of the contents wrap the blob\n"
+  "in a memoryview instead, the blob supports the buffer protocol.");
 
 PyGetSetDef Blob_getseters[] = {
     GETTER(Blob, size),
@@ -51,6 +52,29 @@ PyGetSetDef Blob_getseters[] = {
     {NULL}
 };
 
+static int
+Blob_getbuffer(Blob *self, Py_buffer *view, int flags)
+{
+    /* The buffer points straight into the raw contents kept by libgit2,
+     * they stay valid as long as the Blob (exported by view->obj) is
+     * alive. */
+    return PyBuffer_FillInfo(view, (PyObject *)self,
+                             (void *)git_blob_rawcontent(self->blob),
+                             (Py_ssize_t)git_blob_rawsize(self->blob),
+                             1, flags);
+}
+
+static PyBufferProcs Blob_as_buffer = {
+#if PY_MAJOR_VERSION == 2
+    0,                                  /* bf_getreadbuffer  */
+    0,                                  /* bf_getwritebuffer */
+    0,                                  /* bf_getsegcount    */
+    0,                                  /* bf_getcharbuffer  */
+#endif
+    (getbufferproc)Blob_getbuffer,      /* bf_getbuffer      */
+    0,                                  /* bf_releasebuffer  */
+};
+
 
 PyDoc_STRVAR(Blob__doc__, "Blob objects.");
 
@@ -73,8 +97,13 @@ PyTypeObject BlobType = {
     0,                                         /* tp_str            */
     0,                                         /* tp_getattro       */
     0,                                         /* tp_setattro       */
-    0,                                         /* tp_as_buffer      */
-    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,  /* tp_flags          */
+    &Blob_as_buffer,                           /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT |
+    Py_TPFLAGS_BASETYPE |
+#if PY_MAJOR_VERSION == 2
+    Py_TPFLAGS_HAVE_NEWBUFFER |
+#endif
+    0,                                         /* tp_flags          */
     Blob__doc__,                               /* tp_doc            */
     0,                                         /* tp_traverse       */
     0,                                         /* tp_clear          */
@@ -28,7 +28,9 @@
 #include "types.h"
 #include "branch.h"
 #include "error.h"
+#include "oid.h"
 #include "reference.h"
+#include "repository.h"
 #include "utils.h"
 
 
@@ -53,6 +55,7 @@ Branch_delete(Branch *self, PyObject *args)
     if (err < 0)
         return Error_set(err);
 
+    Repository_invalidate_ref_caches(self->repo);
     git_reference_free(self->reference);
     self->reference = NULL; /* Invalidate the pointer */
 
@@ -101,10 +104,11 @@ PyObject* Branch_rename(Branch *self, PyObject *args)
         return NULL;
 
     err = git_branch_move(&c_out, self->reference, c_name, force);
-    if (err == GIT_OK)
-        return wrap_branch(c_out, self->repo);
-    else
+    if (err < 0)
         return Error_set(err);
+
+    Repository_invalidate_ref_caches(self->repo);
+    return wrap_branch(c_out, self->repo);
 }
 
 
@@ -316,14 +320,110 @@ wrap_branch(git_reference *c_reference, Repository *repo)
 {
     Branch *py_branch=NULL;
 
-    py_branch = PyObject_New(Branch, &BranchType);
+    py_branch = PyObject_GC_New(Branch, &BranchType);
     if (py_branch) {
         py_branch->reference = c_reference;
-        if (repo) {
-            py_branch->repo = repo;
-            Py_INCREF(repo);
-        }
+        py_branch->repo = repo;
+        Py_XINCREF(repo);
+        PyObject_GC_Track(py_branch);
     }
 
     return (PyObject *)py_branch;
 }
+
+
+void
+BranchesIter_dealloc(BranchesIter *self)
+{
+    size_t i;
+
+    for (i = 0; i < self->count; i++)
+        free(self->names[i]);
+    free(self->names);
+    free(self->types);
+    Py_CLEAR(self->repo);
+    PyObject_Del(self);
+}
+
+PyObject *
+BranchesIter_iternext(BranchesIter *self)
+{
+    git_reference *c_reference, *resolved = NULL;
+    const git_oid *oid;
+    const char *name;
+    git_branch_t branch_type;
+    PyObject *py_target, *py_is_head;
+    PyObject *py_record;
+    int err;
+
+    if (self->i >= self->count) {
+        PyErr_SetNone(PyExc_StopIteration);
+        return NULL;
+    }
+
+    name = self->names[self->i];
+    branch_type = self->types[self->i];
+    self->i++;
+
+    err = git_branch_lookup(&c_reference, self->repo->repo, name,
+                            branch_type);
+    if (err < 0)
+        return Error_set_str(err, name);
+
+    /* A branch is normally a direct reference, the resolve is only for
+     * the odd symbolic one. */
+    oid = git_reference_target(c_reference);
+    if (oid == NULL) {
+        err = git_reference_resolve(&resolved, c_reference);
+        if (err < 0) {
+            git_reference_free(c_reference);
+            return Error_set_str(err, name);
+        }
+        oid = git_reference_target(resolved);
+    }
+
+    py_target = oid ? git_oid_to_python(oid) : Py_None;
+    if (oid == NULL)
+        Py_INCREF(py_target);
+
+    py_is_head = git_branch_is_head(c_reference) == 1 ? Py_True : Py_False;
+
+    git_reference_free(resolved);
+    git_reference_free(c_reference);
+
+    py_record = Py_BuildValue("(NNO)", to_path(name), py_target,
+                              py_is_head);
+    return py_record;
+}
+
+PyDoc_STRVAR(BranchesIterType__doc__, "Internal branch record iterator object.");
+
+PyTypeObject BranchesIterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.BranchesIter",                    /* tp_name           */
+    sizeof(BranchesIter),                      /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)BranchesIter_dealloc,          /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    0,                                         /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    BranchesIterType__doc__,                   /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    PyObject_SelfIter,                         /* tp_iter           */
+    (iternextfunc)BranchesIter_iternext,       /* tp_iternext       */
+};
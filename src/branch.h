@@ -37,5 +37,7 @@ PyObject* Branch_is_head(Branch *self);
 PyObject* Branch_move(Branch *self, PyObject *args);
 
 PyObject* wrap_branch(git_reference *c_reference, Repository *repo);
+void BranchesIter_dealloc(BranchesIter *self);
+PyObject* BranchesIter_iternext(BranchesIter *self);
 
 #endif
@@ -29,6 +29,7 @@
 #include <Python.h>
 #include "error.h"
 #include "utils.h"
+#include "oid.h"
 #include "signature.h"
 #include "commit.h"
 #include "object.h"
@@ -127,7 +128,6 @@ PyObject *
 Commit_tree__get__(Commit *commit)
 {
     git_tree *tree;
-    Tree *py_tree;
     int err;
 
     err = git_commit_tree(&tree, commit->commit);
@@ -137,13 +137,8 @@ Commit_tree__get__(Commit *commit)
     if (err < 0)
         return Error_set(err);
 
-    py_tree = PyObject_New(Tree, &TreeType);
-    if (py_tree) {
-        Py_INCREF(commit->repo);
-        py_tree->repo = commit->repo;
-        py_tree->tree = (git_tree*)tree;
-    }
-    return (PyObject*)py_tree;
+    /* Share an already-alive wrapper for this tree, if any */
+    return wrap_object((git_object*)tree, commit->repo);
 }
 
 
@@ -192,6 +187,44 @@ Commit_parents__get__(Commit *self)
     return list;
 }
 
+PyDoc_STRVAR(Commit_parent_ids__doc__,
+  "The list of parent commit ids, without looking up the objects.");
+
+PyObject *
+Commit_parent_ids__get__(Commit *self)
+{
+    unsigned int i, parent_count;
+    const git_oid *parent_oid;
+    PyObject *py_oid;
+    PyObject *list;
+
+    parent_count = git_commit_parentcount(self->commit);
+    list = PyList_New(parent_count);
+    if (!list)
+        return NULL;
+
+    /* The parent ids are available from the commit header, no object
+     * database lookup is needed. */
+    for (i=0; i < parent_count; i++) {
+        parent_oid = git_commit_parent_id(self->commit, i);
+        if (parent_oid == NULL) {
+            Py_DECREF(list);
+            Error_set(GIT_ENOTFOUND);
+            return NULL;
+        }
+
+        py_oid = git_oid_to_python(parent_oid);
+        if (py_oid == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+
+        PyList_SET_ITEM(list, i, py_oid);
+    }
+
+    return list;
+}
+
 PyGetSetDef Commit_getseters[] = {
     GETTER(Commit, message_encoding),
     GETTER(Commit, message),
@@ -202,6 +235,7 @@ PyGetSetDef Commit_getseters[] = {
     GETTER(Commit, author),
     GETTER(Commit, tree),
     GETTER(Commit, parents),
+    GETTER(Commit, parent_ids),
     {NULL}
 };
 
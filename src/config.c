@@ -303,6 +303,58 @@ Config_foreach(Config *self, PyObject *args)
 }
 
 
+static int
+config_to_dict_cb(const git_config_entry *entry, void *payload)
+{
+    PyObject *py_dict = (PyObject *)payload;
+    PyObject *py_value;
+    int err;
+
+    if (entry->value != NULL)
+        py_value = to_unicode(entry->value, NULL, NULL);
+    else {
+        py_value = Py_None;
+        Py_INCREF(py_value);
+    }
+    if (py_value == NULL)
+        return -1;
+
+    err = PyDict_SetItemString(py_dict, entry->name, py_value);
+    Py_DECREF(py_value);
+    return err;
+}
+
+PyDoc_STRVAR(Config_to_dict__doc__,
+  "to_dict() -> {str: str, ...}\n"
+  "\n"
+  "Extract all the config variables in one pass and return them as a\n"
+  "dict mapping the normalized names to their values. The dict is a\n"
+  "plain snapshot: reading many keys from it costs dict probes instead\n"
+  "of file-backed lookups, and later changes to the config are not\n"
+  "reflected.");
+
+PyObject *
+Config_to_dict(Config *self)
+{
+    PyObject *py_dict;
+    int ret;
+
+    py_dict = PyDict_New();
+    if (py_dict == NULL)
+        return NULL;
+
+    ret = git_config_foreach(self->config, config_to_dict_cb, py_dict);
+    if (ret != 0) {
+        Py_DECREF(py_dict);
+        if (PyErr_Occurred())
+            return NULL;
+        return Error_set(ret);
+    }
+
+    return py_dict;
+}
+
+
 PyDoc_STRVAR(Config_add_file__doc__,
   "add_file(path, level=0, force=0)\n"
   "\n"
@@ -422,6 +474,7 @@ PyMethodDef Config_methods[] = {
     METHOD(Config, get_system_config, METH_NOARGS | METH_STATIC),
     METHOD(Config, get_global_config, METH_NOARGS | METH_STATIC),
     METHOD(Config, foreach, METH_VARARGS),
+    METHOD(Config, to_dict, METH_NOARGS),
     METHOD(Config, add_file, METH_VARARGS | METH_KEYWORDS),
     METHOD(Config, get_multivar, METH_VARARGS),
     METHOD(Config, set_multivar, METH_VARARGS),
@@ -31,7 +31,9 @@
 #include "error.h"
 #include "types.h"
 #include "utils.h"
+#include "oid.h"
 #include "diff.h"
+#include "instrumentation.h"
 
 extern PyObject *GitError;
 
@@ -58,100 +60,129 @@ wrap_diff(git_diff_list *diff, Repository *repo)
 }
 
 PyObject*
-diff_get_patch_byindex(git_diff_list* list, size_t idx)
+diff_get_patch_byindex(Diff *self, size_t idx)
 {
     const git_diff_delta* delta;
-    const git_diff_range* range;
     git_diff_patch* patch = NULL;
-    size_t i, j, hunk_amounts, lines_in_hunk, line_len, header_len;
-    const char* line, *header;
-    char line_origin;
     int err;
-    Hunk *py_hunk = NULL;
-    Patch *py_patch = NULL;
-    PyObject *py_line_origin=NULL, *py_line=NULL;
+    Patch *py_patch;
 
-    err = git_diff_get_patch(&patch, &delta, list, idx);
+    Py_BEGIN_ALLOW_THREADS
+    err = git_diff_get_patch(&patch, &delta, self->list, idx);
+    Py_END_ALLOW_THREADS
     if (err < 0)
         return Error_set(err);
 
     py_patch = PyObject_New(Patch, &PatchType);
-    if (py_patch != NULL) {
-        py_patch->old_file_path = delta->old_file.path;
-        py_patch->new_file_path = delta->new_file.path;
-        py_patch->status = git_diff_status_char(delta->status);
-        py_patch->similarity = delta->similarity;
-        py_patch->old_oid = git_oid_allocfmt(&delta->old_file.oid);
-        py_patch->new_oid = git_oid_allocfmt(&delta->new_file.oid);
+    if (py_patch == NULL) {
+        git_diff_patch_free(patch);
+        return NULL;
+    }
+
+    /* The git_diff_patch is kept alive so that hunks and lines can be
+     * materialized lazily, only when they are accessed. */
+    Py_INCREF(self);
+    py_patch->diff = self;
+    py_patch->patch = patch;
+    py_patch->hunks = NULL;
+    py_patch->old_file_path = delta->old_file.path;
+    py_patch->new_file_path = delta->new_file.path;
+    py_patch->status = git_diff_status_char(delta->status);
+    py_patch->similarity = delta->similarity;
+    git_oid_cpy(&py_patch->old_oid, &delta->old_file.oid);
+    git_oid_cpy(&py_patch->new_oid, &delta->new_file.oid);
+
+    return (PyObject*) py_patch;
+}
+
+PyDoc_STRVAR(Patch_hunks__doc__,
+  "The list of hunks, built on first access.");
+
+PyObject *
+Patch_hunks__get__(Patch *self)
+{
+    const git_diff_range* range;
+    const char* header;
+    size_t i, hunk_amounts, lines_in_hunk, header_len;
+    int err;
+    Hunk *py_hunk;
 
+    if (self->hunks == NULL) {
+        hunk_amounts = git_diff_patch_num_hunks(self->patch);
+        self->hunks = PyList_New(hunk_amounts);
+        if (self->hunks == NULL)
+            return NULL;
 
-        hunk_amounts = git_diff_patch_num_hunks(patch);
-        py_patch->hunks = PyList_New(hunk_amounts);
         for (i=0; i < hunk_amounts; ++i) {
             err = git_diff_patch_get_hunk(&range, &header, &header_len,
-                      &lines_in_hunk, patch, i);
-
-            if (err < 0)
-                goto cleanup;
+                      &lines_in_hunk, self->patch, i);
+            if (err < 0) {
+                Py_CLEAR(self->hunks);
+                return Error_set(err);
+            }
 
             py_hunk = PyObject_New(Hunk, &HunkType);
-            if (py_hunk != NULL) {
-                py_hunk->old_start = range->old_start;
-                py_hunk->old_lines = range->old_lines;
-                py_hunk->new_start = range->new_start;
-                py_hunk->new_lines = range->new_lines;
-
-                py_hunk->lines = PyList_New(lines_in_hunk);
-                for (j=0; j < lines_in_hunk; ++j) {
-                    err = git_diff_patch_get_line_in_hunk(&line_origin,
-                              &line, &line_len, NULL, NULL, patch, i, j);
-
-                    if (err < 0)
-                      goto cleanup;
-
-                    py_line_origin = to_unicode_n(&line_origin, 1, NULL, NULL);
-                    py_line = to_unicode_n(line, line_len, NULL, NULL);
-                    PyList_SetItem(py_hunk->lines, j,
-                        Py_BuildValue("OO",
-                            py_line_origin,
-                            py_line
-                        )
-                    );
-                    Py_DECREF(py_line_origin);
-                    Py_DECREF(py_line);
-                }
-
-                PyList_SetItem((PyObject*) py_patch->hunks, i,
-                    (PyObject*) py_hunk);
+            if (py_hunk == NULL) {
+                Py_CLEAR(self->hunks);
+                return NULL;
             }
+
+            Py_INCREF(self);
+            py_hunk->patch = self;
+            py_hunk->idx = i;
+            py_hunk->lines = NULL;
+            py_hunk->old_start = range->old_start;
+            py_hunk->old_lines = range->old_lines;
+            py_hunk->new_start = range->new_start;
+            py_hunk->new_lines = range->new_lines;
+
+            PyList_SET_ITEM(self->hunks, i, (PyObject*) py_hunk);
         }
     }
 
-cleanup:
-    git_diff_patch_free(patch);
-
-    return (err < 0) ? Error_set(err) : (PyObject*) py_patch;
+    Py_INCREF(self->hunks);
+    return self->hunks;
 }
 
 static void
 Patch_dealloc(Patch *self)
 {
     Py_CLEAR(self->hunks);
-    free(self->old_oid);
-    free(self->new_oid);
-    // we do not have to free old_file_path and new_file_path, they will
-    // be freed by git_diff_list_free in Diff_dealloc
+    git_diff_patch_free(self->patch);
+    /* old_file_path and new_file_path are owned by the diff list, which
+     * is kept alive through self->diff */
+    Py_CLEAR(self->diff);
     PyObject_Del(self);
 }
 
+PyDoc_STRVAR(Patch_old_oid__doc__, "old oid");
+
+PyObject *
+Patch_old_oid__get__(Patch *self)
+{
+    return git_oid_to_py_str(&self->old_oid);
+}
+
+PyDoc_STRVAR(Patch_new_oid__doc__, "new oid");
+
+PyObject *
+Patch_new_oid__get__(Patch *self)
+{
+    return git_oid_to_py_str(&self->new_oid);
+}
+
 PyMemberDef Patch_members[] = {
     MEMBER(Patch, old_file_path, T_STRING, "old file path"),
     MEMBER(Patch, new_file_path, T_STRING, "new file path"),
-    MEMBER(Patch, old_oid, T_STRING, "old oid"),
-    MEMBER(Patch, new_oid, T_STRING, "new oid"),
     MEMBER(Patch, status, T_CHAR, "status"),
     MEMBER(Patch, similarity, T_INT, "similarity"),
-    MEMBER(Patch, hunks, T_OBJECT, "hunks"),
+    {NULL}
+};
+
+PyGetSetDef Patch_getseters[] = {
+    GETTER(Patch, old_oid),
+    GETTER(Patch, new_oid),
+    GETTER(Patch, hunks),
     {NULL}
 };
 
@@ -187,7 +218,7 @@ PyTypeObject PatchType = {
     0,                                         /* tp_iternext       */
     0,                                         /* tp_methods        */
     Patch_members,                             /* tp_members        */
-    0,                                         /* tp_getset         */
+    Patch_getseters,                           /* tp_getset         */
     0,                                         /* tp_base           */
     0,                                         /* tp_dict           */
     0,                                         /* tp_descr_get      */
@@ -202,8 +233,14 @@ PyTypeObject PatchType = {
 PyObject *
 DiffIter_iternext(DiffIter *self)
 {
-    if (self->i < self->n)
-        return diff_get_patch_byindex(self->diff->list, self->i++);
+    PyObject *py_patch;
+    STATS_START(t);
+
+    if (self->i < self->n) {
+        py_patch = diff_get_patch_byindex(self->diff, self->i++);
+        STATS_END(STATS_DIFFITER_ITERNEXT, t);
+        return py_patch;
+    }
 
     PyErr_SetNone(PyExc_StopIteration);
     return NULL;
@@ -250,54 +287,346 @@ PyTypeObject DiffIterType = {
 };
 
 
+PyObject *
+DeltaIter_iternext(DeltaIter *self)
+{
+    const git_diff_delta *delta;
+
+    if (self->i >= self->n) {
+        PyErr_SetNone(PyExc_StopIteration);
+        return NULL;
+    }
+
+    /* The delta is borrowed from the diff list, no blobs are loaded and
+     * no patch is generated for it. */
+    delta = git_diff_get_delta(self->diff->list, self->i++);
+
+    return Py_BuildValue(
+#if PY_MAJOR_VERSION == 2
+        "(NNcI)",
+#else
+        "(NNCI)",
+#endif
+        to_path(delta->old_file.path),
+        to_path(delta->new_file.path),
+        git_diff_status_char(delta->status),
+        delta->similarity);
+}
+
+
+PyDoc_STRVAR(DeltaIter__doc__, "Delta iterator object.");
+
+PyTypeObject DeltaIterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.DeltaIter",                       /* tp_name           */
+    sizeof(DeltaIter),                         /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)DiffIter_dealloc,              /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    0,                                         /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,  /* tp_flags          */
+    DeltaIter__doc__,                          /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    PyObject_SelfIter,                         /* tp_iter           */
+    (iternextfunc) DeltaIter_iternext,         /* tp_iternext       */
+};
+
+
+static int
+diff_print_write_cb(const git_diff_delta *delta, const git_diff_range *range,
+                    char line_origin, const char *content, size_t content_len,
+                    void *payload)
+{
+    /* This is the callback that will be called in git_diff_print_patch.
+     * It is called once per line of patch text, with payload being the
+     * file-like object the text is written to. */
+    PyObject *py_file = (PyObject*) payload;
+    PyObject *py_content, *py_result;
+
+    py_content = to_unicode_n(content, content_len, NULL, NULL);
+    if (py_content == NULL)
+        return GIT_EUSER;
+
+    py_result = PyObject_CallMethod(py_file, "write", "O", py_content);
+    Py_DECREF(py_content);
+    if (py_result == NULL)
+        return GIT_EUSER;
+
+    Py_DECREF(py_result);
+    return 0;
+}
+
+static int
+diff_print_append_cb(const git_diff_delta *delta, const git_diff_range *range,
+                     char line_origin, const char *content, size_t content_len,
+                     void *payload)
+{
+    PyObject *py_chunks = (PyObject*) payload;
+    PyObject *py_content;
+    int err;
+
+    py_content = to_unicode_n(content, content_len, NULL, NULL);
+    if (py_content == NULL)
+        return GIT_EUSER;
+
+    err = PyList_Append(py_chunks, py_content);
+    Py_DECREF(py_content);
+    return (err < 0) ? GIT_EUSER : 0;
+}
+
+
+PyDoc_STRVAR(Diff_write_patch__doc__,
+  "write_patch(file)\n"
+  "\n"
+  "Write the diff as patch text to any object with a write() method.\n"
+  "The text is emitted one line at a time through the libgit2 print\n"
+  "callbacks, so unlike the patch attribute the whole patch is never\n"
+  "held in memory.");
+
+PyObject *
+Diff_write_patch(Diff *self, PyObject *py_file)
+{
+    int err;
+
+    err = git_diff_print_patch(self->list, diff_print_write_cb, py_file);
+    if (err == GIT_EUSER)
+        return NULL;
+    if (err < 0)
+        return Error_set(err);
+
+    Py_RETURN_NONE;
+}
+
+
 PyDoc_STRVAR(Diff_patch__doc__, "Patch diff string.");
 
 PyObject *
 Diff_patch__get__(Diff *self)
 {
-    const git_diff_delta* delta;
-    git_diff_patch* patch;
-    char **strings = NULL;
-    char *buffer = NULL;
-    int err = GIT_ERROR;
-    size_t i, len, num;
-    PyObject *py_patch = NULL;
+    PyObject *py_chunks, *py_sep, *py_patch = NULL;
+    int err;
 
-    num = git_diff_num_deltas(self->list);
-    MALLOC(strings, num * sizeof(char*), cleanup);
+    py_chunks = PyList_New(0);
+    if (py_chunks == NULL)
+        return NULL;
 
-    for (i = 0, len = 1; i < num ; ++i) {
-        err = git_diff_get_patch(&patch, &delta, self->list, i);
+    err = git_diff_print_patch(self->list, diff_print_append_cb, py_chunks);
+    if (err == 0) {
+        py_sep = to_unicode_n("", 0, NULL, NULL);
+        if (py_sep != NULL) {
+            py_patch = PyUnicode_Join(py_sep, py_chunks);
+            Py_DECREF(py_sep);
+        }
+    }
+    else if (err != GIT_EUSER)
+        Error_set(err);
+
+    Py_DECREF(py_chunks);
+    return py_patch;
+}
+
+
+static int
+diff_patch_line_stats(git_diff_patch *patch, size_t *additions,
+                      size_t *deletions)
+{
+    size_t h, l, num_hunks, lines_in_hunk;
+    const char *content;
+    size_t content_len;
+    int old_lineno, new_lineno;
+    char origin;
+    int err;
+
+    /* Only the line origins are looked at, the content pointers are
+     * borrowed so no line string is ever allocated. */
+    num_hunks = git_diff_patch_num_hunks(patch);
+    for (h = 0; h < num_hunks; h++) {
+        err = git_diff_patch_num_lines_in_hunk(patch, h);
         if (err < 0)
-            goto cleanup;
+            return err;
+        lines_in_hunk = (size_t)err;
 
-        err = git_diff_patch_to_str(&(strings[i]), patch);
+        for (l = 0; l < lines_in_hunk; l++) {
+            err = git_diff_patch_get_line_in_hunk(&origin, &content,
+                      &content_len, &old_lineno, &new_lineno, patch, h, l);
+            if (err < 0)
+                return err;
+
+            if (origin == GIT_DIFF_LINE_ADDITION)
+                (*additions)++;
+            else if (origin == GIT_DIFF_LINE_DELETION)
+                (*deletions)++;
+        }
+    }
+
+    return 0;
+}
+
+PyDoc_STRVAR(Diff_stats__doc__,
+  "The (files_changed, insertions, deletions) tuple for the whole diff,\n"
+  "computed at the C level without rendering any patch text. See\n"
+  "Diff.stats_by_file() for a per-file breakdown.");
+
+PyObject *
+Diff_stats__get__(Diff *self)
+{
+    size_t i, n, additions = 0, deletions = 0;
+    git_diff_patch *patch;
+    size_t add, del;
+    int err = 0;
+
+    n = git_diff_num_deltas(self->list);
+
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < n; i++) {
+        err = git_diff_get_patch(&patch, NULL, self->list, i);
         if (err < 0)
-            goto cleanup;
+            break;
 
-        len += strlen(strings[i]);
+        add = 0;
+        del = 0;
+        err = diff_patch_line_stats(patch, &add, &del);
         git_diff_patch_free(patch);
-    }
+        if (err < 0)
+            break;
 
-    CALLOC(buffer, (len + 1), sizeof(char), cleanup);
-    for (i = 0; i < num; ++i) {
-        strcat(buffer, strings[i]);
-        free(strings[i]);
+        additions += add;
+        deletions += del;
     }
-    free(strings);
+    Py_END_ALLOW_THREADS
 
-    py_patch = to_unicode(buffer, NULL, NULL);
-    free(buffer);
+    if (err < 0)
+        return Error_set(err);
 
-cleanup:
-    return (err < 0) ? Error_set(err) : py_patch;
+    return Py_BuildValue("(nnn)", (Py_ssize_t)n, (Py_ssize_t)additions,
+                         (Py_ssize_t)deletions);
 }
 
 
+PyDoc_STRVAR(Diff_stats_by_file__doc__,
+  "stats_by_file() -> {path: (insertions, deletions)}\n"
+  "\n"
+  "Per-file breakdown of Diff.stats, keyed by the new file path.");
+
+PyObject *
+Diff_stats_by_file(Diff *self)
+{
+    PyObject *py_result, *py_path, *py_stats;
+    size_t i, n, add, del;
+    git_diff_patch *patch;
+    const git_diff_delta *delta;
+    int err, set_err;
+
+    py_result = PyDict_New();
+    if (py_result == NULL)
+        return NULL;
+
+    n = git_diff_num_deltas(self->list);
+    for (i = 0; i < n; i++) {
+        add = 0;
+        del = 0;
+        Py_BEGIN_ALLOW_THREADS
+        err = git_diff_get_patch(&patch, &delta, self->list, i);
+        if (err == 0) {
+            err = diff_patch_line_stats(patch, &add, &del);
+            git_diff_patch_free(patch);
+        }
+        Py_END_ALLOW_THREADS
+        if (err < 0) {
+            Py_DECREF(py_result);
+            return Error_set(err);
+        }
+
+        py_path = to_path(delta->new_file.path);
+        if (py_path == NULL) {
+            Py_DECREF(py_result);
+            return NULL;
+        }
+
+        py_stats = Py_BuildValue("(nn)", (Py_ssize_t)add, (Py_ssize_t)del);
+        if (py_stats == NULL) {
+            Py_DECREF(py_path);
+            Py_DECREF(py_result);
+            return NULL;
+        }
+
+        set_err = PyDict_SetItem(py_result, py_path, py_stats);
+        Py_DECREF(py_path);
+        Py_DECREF(py_stats);
+        if (set_err < 0) {
+            Py_DECREF(py_result);
+            return NULL;
+        }
+    }
+
+    return py_result;
+}
+
+
+PyDoc_STRVAR(Hunk_lines__doc__,
+  "The list of (origin, content) tuples, built on first access.");
+
+PyObject *
+Hunk_lines__get__(Hunk *self)
+{
+    size_t j, line_len;
+    const char* line;
+    char line_origin;
+    int err, lines_in_hunk;
+    PyObject *py_line_origin, *py_line;
+
+    if (self->lines == NULL) {
+        lines_in_hunk = git_diff_patch_num_lines_in_hunk(self->patch->patch,
+                                                         self->idx);
+        if (lines_in_hunk < 0)
+            return Error_set(lines_in_hunk);
+
+        self->lines = PyList_New(lines_in_hunk);
+        if (self->lines == NULL)
+            return NULL;
+
+        for (j=0; j < (size_t)lines_in_hunk; ++j) {
+            err = git_diff_patch_get_line_in_hunk(&line_origin, &line,
+                      &line_len, NULL, NULL, self->patch->patch,
+                      self->idx, j);
+            if (err < 0) {
+                Py_CLEAR(self->lines);
+                return Error_set(err);
+            }
+
+            py_line_origin = to_unicode_n(&line_origin, 1, NULL, NULL);
+            py_line = to_unicode_n(line, line_len, NULL, NULL);
+            PyList_SetItem(self->lines, j,
+                Py_BuildValue("OO", py_line_origin, py_line));
+            Py_DECREF(py_line_origin);
+            Py_DECREF(py_line);
+        }
+    }
+
+    Py_INCREF(self->lines);
+    return self->lines;
+}
+
 static void
 Hunk_dealloc(Hunk *self)
 {
     Py_CLEAR(self->lines);
+    Py_CLEAR(self->patch);
     PyObject_Del(self);
 }
 
@@ -306,7 +635,11 @@ PyMemberDef Hunk_members[] = {
     MEMBER(Hunk, old_lines, T_INT, "Old lines."),
     MEMBER(Hunk, new_start, T_INT, "New start."),
     MEMBER(Hunk, new_lines, T_INT, "New lines."),
-    MEMBER(Hunk, lines, T_OBJECT, "Lines."),
+    {NULL}
+};
+
+PyGetSetDef Hunk_getseters[] = {
+    GETTER(Hunk, lines),
     {NULL}
 };
 
@@ -343,7 +676,7 @@ PyTypeObject HunkType = {
     0,                                         /* tp_iternext       */
     0,                                         /* tp_methods        */
     Hunk_members,                              /* tp_members        */
-    0,                                         /* tp_getset         */
+    Hunk_getseters,                            /* tp_getset         */
     0,                                         /* tp_base           */
     0,                                         /* tp_dict           */
     0,                                         /* tp_descr_get      */
@@ -416,6 +749,27 @@ Diff_iter(Diff *self)
     return (PyObject*)iter;
 }
 
+PyDoc_STRVAR(Diff_deltas__doc__,
+  "Iterator over (old_file_path, new_file_path, status, similarity)\n"
+  "tuples, one per file changed. Unlike iterating over the diff itself,\n"
+  "no patches are generated, so the blobs are never loaded. Use this\n"
+  "when only the file statuses are needed.");
+
+PyObject *
+Diff_deltas__get__(Diff *self)
+{
+    DeltaIter *iter;
+
+    iter = PyObject_New(DeltaIter, &DeltaIterType);
+    if (iter != NULL) {
+        Py_INCREF(self);
+        iter->diff = self;
+        iter->i = 0;
+        iter->n = git_diff_num_deltas(self->list);
+    }
+    return (PyObject*)iter;
+}
+
 PyObject *
 Diff_getitem(Diff *self, PyObject *value)
 {
@@ -426,7 +780,7 @@ Diff_getitem(Diff *self, PyObject *value)
 
     i = PyLong_AsUnsignedLong(value);
 
-    return diff_get_patch_byindex(self->list, i);
+    return diff_get_patch_byindex(self, i);
 }
 
 
@@ -439,7 +793,9 @@ Diff_dealloc(Diff *self)
 }
 
 PyGetSetDef Diff_getseters[] = {
+    GETTER(Diff, deltas),
     GETTER(Diff, patch),
+    GETTER(Diff, stats),
     {NULL}
 };
 
@@ -452,6 +808,8 @@ PyMappingMethods Diff_as_mapping = {
 static PyMethodDef Diff_methods[] = {
     METHOD(Diff, merge, METH_VARARGS),
     METHOD(Diff, find_similar, METH_VARARGS),
+    METHOD(Diff, write_patch, METH_O),
+    METHOD(Diff, stats_by_file, METH_NOARGS),
     {NULL}
 };
 
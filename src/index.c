@@ -33,6 +33,7 @@
 #include "oid.h"
 #include "diff.h"
 #include "index.h"
+#include "instrumentation.h"
 
 extern PyTypeObject IndexType;
 extern PyTypeObject TreeType;
@@ -90,14 +91,143 @@ Index_add(Index *self, PyObject *args)
 {
     int err;
     const char *path;
+    STATS_START(t);
 
     if (!PyArg_ParseTuple(args, "s", &path))
         return NULL;
 
+    Py_BEGIN_ALLOW_THREADS
     err = git_index_add_bypath(self->index, path);
+    Py_END_ALLOW_THREADS
     if (err < 0)
         return Error_set_str(err, path);
 
+    STATS_END(STATS_INDEX_ADD, t);
+    Py_RETURN_NONE;
+}
+
+
+/* Extract a calloc'd array of C paths from a Python list. Returns the
+ * array, or NULL with an exception set. */
+static char **
+pathlist_to_c(PyObject *py_paths, Py_ssize_t *c_count)
+{
+    char **paths;
+    Py_ssize_t count, i;
+
+    if (!PyList_Check(py_paths)) {
+        PyErr_SetString(PyExc_TypeError, "paths must be a list");
+        return NULL;
+    }
+
+    count = PyList_Size(py_paths);
+    paths = calloc(count, sizeof(char*));
+    if (paths == NULL && count > 0) {
+        PyErr_SetNone(PyExc_MemoryError);
+        return NULL;
+    }
+
+    for (i = 0; i < count; i++) {
+        paths[i] = py_path_to_c_str(PyList_GetItem(py_paths, i));
+        if (paths[i] == NULL) {
+            while (i > 0)
+                free(paths[--i]);
+            free(paths);
+            return NULL;
+        }
+    }
+
+    *c_count = count;
+    return paths;
+}
+
+static void
+pathlist_free(char **paths, Py_ssize_t count)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < count; i++)
+        free(paths[i]);
+    free(paths);
+}
+
+
+PyDoc_STRVAR(Index_add_many__doc__,
+  "add_many(paths)\n"
+  "\n"
+  "Add or update index entries from a list of files in disk. The whole\n"
+  "list is processed at the C level, so this is much faster than calling\n"
+  "add() in a loop.");
+
+PyObject *
+Index_add_many(Index *self, PyObject *py_paths)
+{
+    char **paths;
+    Py_ssize_t count, i;
+    Py_ssize_t failed = -1;
+    int err = 0;
+
+    paths = pathlist_to_c(py_paths, &count);
+    if (paths == NULL)
+        return NULL;
+
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < count; i++) {
+        err = git_index_add_bypath(self->index, paths[i]);
+        if (err < 0) {
+            failed = i;
+            break;
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    if (err < 0)
+        Error_set_str(err, paths[failed]);
+
+    pathlist_free(paths, count);
+    if (err < 0)
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+
+PyDoc_STRVAR(Index_add_all__doc__,
+  "add_all([pathspecs])\n"
+  "\n"
+  "Add or update index entries matching files in the working directory.\n"
+  "\n"
+  "Arguments:\n"
+  "\n"
+  "pathspecs: list of path patterns to match. Match all files if empty or\n"
+  "   not given.");
+
+PyObject *
+Index_add_all(Index *self, PyObject *args)
+{
+    git_strarray pathspec = {NULL, 0};
+    PyObject *py_pathspecs = NULL;
+    Py_ssize_t count = 0;
+    int err;
+
+    if (!PyArg_ParseTuple(args, "|O!", &PyList_Type, &py_pathspecs))
+        return NULL;
+
+    if (py_pathspecs != NULL) {
+        pathspec.strings = pathlist_to_c(py_pathspecs, &count);
+        if (pathspec.strings == NULL)
+            return NULL;
+        pathspec.count = count;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    err = git_index_add_all(self->index, &pathspec, 0, NULL, NULL);
+    Py_END_ALLOW_THREADS
+
+    pathlist_free(pathspec.strings, count);
+    if (err < 0)
+        return Error_set(err);
+
     Py_RETURN_NONE;
 }
 
@@ -142,11 +272,13 @@ Index_diff_to_workdir(Index *self, PyObject *args)
                                         &opts.interhunk_lines))
         return NULL;
 
+    Py_BEGIN_ALLOW_THREADS
     err = git_diff_index_to_workdir(
             &diff,
             self->repo->repo,
             self->index,
             &opts);
+    Py_END_ALLOW_THREADS
 
     if (err < 0)
         return Error_set(err);
@@ -187,8 +319,10 @@ Index_diff_to_tree(Index *self, PyObject *args)
         return NULL;
 
     py_repo = py_tree->repo;
+    Py_BEGIN_ALLOW_THREADS
     err = git_diff_tree_to_index(&diff, py_repo->repo, py_tree->tree,
                                  self->index, &opts);
+    Py_END_ALLOW_THREADS
     if (err < 0)
         return Error_set(err);
 
@@ -232,7 +366,9 @@ Index_read(Index *self)
 {
     int err;
 
+    Py_BEGIN_ALLOW_THREADS
     err = git_index_read(self->index);
+    Py_END_ALLOW_THREADS
     if (err < GIT_OK)
         return Error_set(err);
 
@@ -251,7 +387,9 @@ Index_write(Index *self)
 {
     int err;
 
+    Py_BEGIN_ALLOW_THREADS
     err = git_index_write(self->index);
+    Py_END_ALLOW_THREADS
     if (err < GIT_OK)
         return Error_set(err);
 
@@ -301,12 +439,22 @@ Index_len(Index *self)
     return (Py_ssize_t)git_index_entrycount(self->index);
 }
 
+/* Index iteration churns through IndexEntry objects, keep a small free
+ * list to spare the general allocator. */
+#define INDEX_ENTRY_MAXFREELIST 64
+static IndexEntry *index_entry_freelist[INDEX_ENTRY_MAXFREELIST];
+static int index_entry_numfree = 0;
+
 PyObject *
 wrap_index_entry(const git_index_entry *entry, Index *index)
 {
     IndexEntry *py_entry;
 
-    py_entry = PyObject_New(IndexEntry, &IndexEntryType);
+    if (index_entry_numfree > 0) {
+        py_entry = index_entry_freelist[--index_entry_numfree];
+        (void)PyObject_INIT(py_entry, &IndexEntryType);
+    } else
+        py_entry = PyObject_New(IndexEntry, &IndexEntryType);
     if (py_entry)
         py_entry->entry = entry;
 
@@ -372,6 +520,43 @@ Index_remove(Index *self, PyObject *args)
 }
 
 
+PyDoc_STRVAR(Index_remove_many__doc__,
+  "remove_many(paths)\n"
+  "\n"
+  "Remove a list of entries from the index. The whole list is processed\n"
+  "at the C level, so this is much faster than calling remove() in a\n"
+  "loop.");
+
+PyObject *
+Index_remove_many(Index *self, PyObject *py_paths)
+{
+    char **paths;
+    Py_ssize_t count, i;
+    int err = 0;
+
+    paths = pathlist_to_c(py_paths, &count);
+    if (paths == NULL)
+        return NULL;
+
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < count; i++) {
+        err = git_index_remove(self->index, paths[i], 0);
+        if (err < 0)
+            break;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (err < 0)
+        Error_set(err);
+
+    pathlist_free(paths, count);
+    if (err < 0)
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+
 PyDoc_STRVAR(Index_read_tree__doc__,
   "read_tree(tree)\n"
   "\n"
@@ -393,7 +578,9 @@ Index_read_tree(Index *self, PyObject *value)
     if (err < 0)
         return Error_set(err);
 
+    Py_BEGIN_ALLOW_THREADS
     err = git_index_read_tree(self->index, tree);
+    Py_END_ALLOW_THREADS
     git_tree_free(tree);
     if (err < 0)
         return Error_set(err);
@@ -413,7 +600,9 @@ Index_write_tree(Index *self)
     git_oid oid;
     int err;
 
+    Py_BEGIN_ALLOW_THREADS
     err = git_index_write_tree(&oid, self->index);
+    Py_END_ALLOW_THREADS
     if (err < 0)
         return Error_set(err);
 
@@ -422,7 +611,10 @@ Index_write_tree(Index *self)
 
 PyMethodDef Index_methods[] = {
     METHOD(Index, add, METH_VARARGS),
+    METHOD(Index, add_many, METH_O),
+    METHOD(Index, add_all, METH_VARARGS),
     METHOD(Index, remove, METH_VARARGS),
+    METHOD(Index, remove_many, METH_O),
     METHOD(Index, clear, METH_NOARGS),
     METHOD(Index, diff_to_workdir, METH_VARARGS),
     METHOD(Index, diff_to_tree, METH_VARARGS),
@@ -553,7 +745,11 @@ PyTypeObject IndexIterType = {
 void
 IndexEntry_dealloc(IndexEntry *self)
 {
-    PyObject_Del(self);
+    if (Py_TYPE(self) == &IndexEntryType &&
+        index_entry_numfree < INDEX_ENTRY_MAXFREELIST)
+        index_entry_freelist[index_entry_numfree++] = self;
+    else
+        PyObject_Del(self);
 }
 
 
@@ -571,7 +767,7 @@ PyDoc_STRVAR(IndexEntry_path__doc__, "Path.");
 PyObject *
 IndexEntry_path__get__(IndexEntry *self)
 {
-    return to_path(self->entry->path);
+    return to_path_interned(self->entry->path);
 }
 
 
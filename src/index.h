@@ -33,6 +33,9 @@
 #include <git2.h>
 
 PyObject* Index_add(Index *self, PyObject *args);
+PyObject* Index_add_many(Index *self, PyObject *py_paths);
+PyObject* Index_add_all(Index *self, PyObject *args);
+PyObject* Index_remove_many(Index *self, PyObject *py_paths);
 PyObject* Index_clear(Index *self);
 PyObject* Index_find(Index *self, PyObject *py_path);
 PyObject* Index_read(Index *self);
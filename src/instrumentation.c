@@ -0,0 +1,119 @@
+/*
+ * Copyright 2010-2013 The pygit2 contributors
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2,
+ * as published by the Free Software Foundation.
+ *
+ * In addition to the permissions in the GNU General Public License,
+ * the authors give you unlimited permission to link the compiled
+ * version of this file into combinations with other programs,
+ * and to distribute those combinations without any restriction
+ * coming from the use of this file.  (The General Public License
+ * restrictions do apply in other respects; for example, they cover
+ * modification of the file, and distribution when not linked into
+ * a combined executable.)
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <string.h>
+#include <time.h>
+#include "instrumentation.h"
+
+int stats_enabled = 0;
+
+/* Indexed by stats_func_t, keep in sync with the enum. */
+static const char *stats_names[STATS_FUNC_COUNT] = {
+    "Repository_read",
+    "Repository_lookup",
+    "Repository_status",
+    "Walker_iternext",
+    "DiffIter_iternext",
+    "Index_add",
+};
+
+static struct {
+    unsigned long long calls;
+    double total;
+} stats_counters[STATS_FUNC_COUNT];
+
+double
+stats_clock(void)
+{
+#ifdef _WIN32
+    return (double)clock() / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+void
+stats_record(stats_func_t func, double elapsed)
+{
+    stats_counters[func].calls++;
+    stats_counters[func].total += elapsed;
+}
+
+PyObject *
+get_stats(PyObject *self)
+{
+    PyObject *py_stats, *py_entry;
+    int i;
+
+    py_stats = PyDict_New();
+    if (py_stats == NULL)
+        return NULL;
+
+    for (i = 0; i < STATS_FUNC_COUNT; i++) {
+        py_entry = Py_BuildValue("(Kd)", stats_counters[i].calls,
+                                 stats_counters[i].total);
+        if (py_entry == NULL)
+            goto error;
+
+        if (PyDict_SetItemString(py_stats, stats_names[i], py_entry) < 0) {
+            Py_DECREF(py_entry);
+            goto error;
+        }
+        Py_DECREF(py_entry);
+    }
+
+    return py_stats;
+
+error:
+    Py_DECREF(py_stats);
+    return NULL;
+}
+
+PyObject *
+reset_stats(PyObject *self)
+{
+    memset(stats_counters, 0, sizeof(stats_counters));
+    Py_RETURN_NONE;
+}
+
+PyObject *
+enable_stats(PyObject *self, PyObject *py_enabled)
+{
+    int enabled;
+
+    enabled = PyObject_IsTrue(py_enabled);
+    if (enabled < 0)
+        return NULL;
+
+    stats_enabled = enabled;
+    Py_RETURN_NONE;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2010-2013 The pygit2 contributors
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2,
+ * as published by the Free Software Foundation.
+ *
+ * In addition to the permissions in the GNU General Public License,
+ * the authors give you unlimited permission to link the compiled
+ * version of this file into combinations with other programs,
+ * and to distribute those combinations without any restriction
+ * coming from the use of this file.  (The General Public License
+ * restrictions do apply in other respects; for example, they cover
+ * modification of the file, and distribution when not linked into
+ * a combined executable.)
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDE_pygit2_instrumentation_h
+#define INCLUDE_pygit2_instrumentation_h
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+/* Instrumented binding functions. Keep in sync with the name table in
+ * instrumentation.c. */
+typedef enum {
+    STATS_REPOSITORY_READ,
+    STATS_REPOSITORY_LOOKUP,
+    STATS_REPOSITORY_STATUS,
+    STATS_WALKER_ITERNEXT,
+    STATS_DIFFITER_ITERNEXT,
+    STATS_INDEX_ADD,
+    STATS_FUNC_COUNT
+} stats_func_t;
+
+/* Non-zero while stats collection is enabled, see enable_stats(). */
+extern int stats_enabled;
+
+double stats_clock(void);
+void stats_record(stats_func_t func, double elapsed);
+
+/* The counters are only touched while the GIL is held, instrumented
+ * functions enter and leave with the GIL even if they release it in
+ * between, so no extra locking is needed. */
+#define STATS_START(t) \
+    double t = stats_enabled ? stats_clock() : 0.0
+#define STATS_END(func, t) \
+    do { \
+        if (stats_enabled) \
+            stats_record(func, stats_clock() - (t)); \
+    } while (0)
+
+PyObject* get_stats(PyObject *self);
+PyObject* reset_stats(PyObject *self);
+PyObject* enable_stats(PyObject *self, PyObject *py_enabled);
+
+#endif
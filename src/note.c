@@ -32,6 +32,7 @@
 #include "utils.h"
 #include "types.h"
 #include "oid.h"
+#include "repository.h"
 #include "note.h"
 
 extern PyTypeObject SignatureType;
@@ -44,7 +45,6 @@ Note_remove(Note *self, PyObject* args)
 {
     char *ref = "refs/notes/commits";
     int err = GIT_ERROR;
-    git_oid annotated_id;
     Signature *py_author, *py_committer;
 
     if (!PyArg_ParseTuple(args, "O!O!|s",
@@ -53,19 +53,25 @@ Note_remove(Note *self, PyObject* args)
                           &ref))
         return NULL;
 
-    err = git_oid_fromstr(&annotated_id, self->annotated_id);
-    if (err < 0)
-        return Error_set(err);
-
     err = git_note_remove(self->repo->repo, ref, py_author->signature,
-        py_committer->signature, &annotated_id);
+        py_committer->signature, &self->annotated_id);
     if (err < 0)
         return Error_set(err);
 
+    Repository_invalidate_ref_caches(self->repo);
     Py_RETURN_NONE;
 }
 
 
+PyDoc_STRVAR(Note_annotated_id__doc__, "id of the annotated object.");
+
+PyObject *
+Note_annotated_id__get__(Note *self)
+{
+    return git_oid_to_py_str(&self->annotated_id);
+}
+
+
 PyDoc_STRVAR(Note_oid__doc__,
   "Gets the id of the blob containing the note message\n");
 
@@ -90,7 +96,6 @@ static void
 Note_dealloc(Note *self)
 {
     Py_CLEAR(self->repo);
-    free(self->annotated_id);
     git_note_free(self->note);
     PyObject_Del(self);
 }
@@ -101,12 +106,8 @@ PyMethodDef Note_methods[] = {
     {NULL}
 };
 
-PyMemberDef Note_members[] = {
-    MEMBER(Note, annotated_id, T_STRING, "id of the annotated object."),
-    {NULL}
-};
-
 PyGetSetDef Note_getseters[] = {
+    GETTER(Note, annotated_id),
     GETTER(Note, message),
     GETTER(Note, oid),
     {NULL}
@@ -143,7 +144,7 @@ PyTypeObject NoteType = {
     0,                                         /* tp_iter           */
     0,                                         /* tp_iternext       */
     Note_methods,                              /* tp_methods        */
-    Note_members,                              /* tp_members        */
+    0,                                         /* tp_members        */
     Note_getseters,                            /* tp_getset         */
     0,                                         /* tp_base           */
     0,                                         /* tp_dict           */
@@ -229,7 +230,7 @@ wrap_note(Repository* repo, git_oid* annotated_id, const char* ref)
 
     py_note->repo = repo;
     Py_INCREF(repo);
-    py_note->annotated_id = git_oid_allocfmt(annotated_id);
+    git_oid_cpy(&py_note->annotated_id, annotated_id);
 
     return (PyObject*) py_note;
 }
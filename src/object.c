@@ -43,9 +43,24 @@ extern PyTypeObject TagType;
 void
 Object_dealloc(Object* self)
 {
+    PyObject_GC_UnTrack(self);
     Py_CLEAR(self->repo);
     git_object_free(self->obj);
-    PyObject_Del(self);
+    PyObject_GC_Del(self);
+}
+
+int
+Object_traverse(Object *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->repo);
+    return 0;
+}
+
+int
+Object_clear(Object *self)
+{
+    Py_CLEAR(self->repo);
+    return 0;
 }
 
 
@@ -117,6 +132,29 @@ Object_read_raw(Object *self)
     return aux;
 }
 
+PyDoc_STRVAR(Object_peel__doc__,
+  "peel(target_type) -> Object\n"
+  "\n"
+  "Peel the object until an object of the given target type (one of the\n"
+  "GIT_OBJ_* constants) is found. The whole chain is followed in C, no\n"
+  "wrapper is built for the intermediate objects.");
+
+PyObject *
+Object_peel(Object *self, PyObject *args)
+{
+    int type, err;
+    git_object *peeled;
+
+    if (!PyArg_ParseTuple(args, "i", &type))
+        return NULL;
+
+    err = git_object_peel(&peeled, self->obj, type);
+    if (err < 0)
+        return Error_set(err);
+
+    return wrap_object(peeled, self->repo);
+}
+
 PyGetSetDef Object_getseters[] = {
     GETTER(Object, oid),
     GETTER(Object, hex),
@@ -126,6 +164,7 @@ PyGetSetDef Object_getseters[] = {
 
 PyMethodDef Object_methods[] = {
     METHOD(Object, read_raw, METH_NOARGS),
+    METHOD(Object, peel, METH_VARARGS),
     {NULL}
 };
 
@@ -152,10 +191,11 @@ PyTypeObject ObjectType = {
     0,                                         /* tp_getattro       */
     0,                                         /* tp_setattro       */
     0,                                         /* tp_as_buffer      */
-    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,  /* tp_flags          */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE |
+        Py_TPFLAGS_HAVE_GC,                    /* tp_flags          */
     Object__doc__,                             /* tp_doc            */
-    0,                                         /* tp_traverse       */
-    0,                                         /* tp_clear          */
+    (traverseproc)Object_traverse,             /* tp_traverse       */
+    (inquiry)Object_clear,                     /* tp_clear          */
     0,                                         /* tp_richcompare    */
     0,                                         /* tp_weaklistoffset */
     0,                                         /* tp_iter           */
@@ -177,19 +217,31 @@ PyObject *
 wrap_object(git_object *c_object, Repository *repo)
 {
     Object *py_obj = NULL;
+    PyObject *py_cached;
+
+    /* The object cache doubles as an identity map: when a wrapper for
+     * this oid is already alive, hand out that one instead of
+     * allocating a second copy of the same object. */
+    if (repo != NULL) {
+        py_cached = Repository_cache_get(repo, git_object_id(c_object));
+        if (py_cached != NULL) {
+            git_object_free(c_object);
+            return py_cached;
+        }
+    }
 
     switch (git_object_type(c_object)) {
         case GIT_OBJ_COMMIT:
-            py_obj = PyObject_New(Object, &CommitType);
+            py_obj = PyObject_GC_New(Object, &CommitType);
             break;
         case GIT_OBJ_TREE:
-            py_obj = PyObject_New(Object, &TreeType);
+            py_obj = PyObject_GC_New(Object, &TreeType);
             break;
         case GIT_OBJ_BLOB:
-            py_obj = PyObject_New(Object, &BlobType);
+            py_obj = PyObject_GC_New(Object, &BlobType);
             break;
         case GIT_OBJ_TAG:
-            py_obj = PyObject_New(Object, &TagType);
+            py_obj = PyObject_GC_New(Object, &TagType);
             break;
         default:
             assert(0);
@@ -197,10 +249,11 @@ wrap_object(git_object *c_object, Repository *repo)
 
     if (py_obj) {
         py_obj->obj = c_object;
-        if (repo) {
-            py_obj->repo = repo;
-            Py_INCREF(repo);
-        }
+        py_obj->repo = repo;
+        Py_XINCREF(repo);
+        PyObject_GC_Track(py_obj);
+        if (repo != NULL)
+            Repository_cache_put(repo, py_obj);
     }
     return (PyObject *)py_obj;
 }
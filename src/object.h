@@ -37,6 +37,7 @@ PyObject* Object_get_oid(Object *self);
 PyObject* Object_get_hex(Object *self);
 PyObject* Object_get_type(Object *self);
 PyObject* Object_read_raw(Object *self);
+PyObject* Object_peel(Object *self, PyObject *args);
 PyObject* wrap_object(git_object *c_object, Repository *repo);
 
 #endif
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2010-2013 The pygit2 contributors
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2,
+ * as published by the Free Software Foundation.
+ *
+ * In addition to the permissions in the GNU General Public License,
+ * the authors give you unlimited permission to link the compiled
+ * version of this file into combinations with other programs,
+ * and to distribute those combinations without any restriction
+ * coming from the use of this file.  (The General Public License
+ * restrictions do apply in other respects; for example, they cover
+ * modification of the file, and distribution when not linked into
+ * a combined executable.)
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "error.h"
+#include "utils.h"
+#include "oid.h"
+#include "packbuilder.h"
+
+void
+PackBuilder_dealloc(PackBuilder *self)
+{
+    Py_CLEAR(self->repo);
+    git_packbuilder_free(self->pb);
+    PyObject_Del(self);
+}
+
+
+PyDoc_STRVAR(PackBuilder_set_threads__doc__,
+  "set_threads(n) -> int\n"
+  "\n"
+  "Set the number of threads to use for delta compression and return\n"
+  "the number actually set. Pass 0 to autodetect the number of CPUs.");
+
+PyObject *
+PackBuilder_set_threads(PackBuilder *self, PyObject *py_threads)
+{
+    long threads;
+
+    threads = PyLong_AsLong(py_threads);
+    if (threads == -1 && PyErr_Occurred())
+        return NULL;
+
+    if (threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "threads must not be negative");
+        return NULL;
+    }
+
+    threads = git_packbuilder_set_threads(self->pb, (unsigned int)threads);
+    return PyLong_FromLong(threads);
+}
+
+
+PyDoc_STRVAR(PackBuilder_insert__doc__,
+  "insert(oid)\n"
+  "\n"
+  "Insert a single object into the pack.");
+
+PyObject *
+PackBuilder_insert(PackBuilder *self, PyObject *py_oid)
+{
+    int err;
+    git_oid oid;
+
+    err = py_oid_to_git_oid_expand(self->repo->repo, py_oid, &oid);
+    if (err < 0)
+        return NULL;
+
+    err = git_packbuilder_insert(self->pb, &oid, NULL);
+    if (err < 0)
+        return Error_set(err);
+
+    Py_RETURN_NONE;
+}
+
+
+PyDoc_STRVAR(PackBuilder_insert_commit__doc__,
+  "insert_commit(oid)\n"
+  "\n"
+  "Insert a commit and its complete tree into the pack.");
+
+PyObject *
+PackBuilder_insert_commit(PackBuilder *self, PyObject *py_oid)
+{
+    int err;
+    git_oid oid;
+
+    err = py_oid_to_git_oid_expand(self->repo->repo, py_oid, &oid);
+    if (err < 0)
+        return NULL;
+
+    err = git_packbuilder_insert_commit(self->pb, &oid);
+    if (err < 0)
+        return Error_set(err);
+
+    Py_RETURN_NONE;
+}
+
+
+PyDoc_STRVAR(PackBuilder_insert_tree__doc__,
+  "insert_tree(oid)\n"
+  "\n"
+  "Insert a tree and all the objects it references into the pack.");
+
+PyObject *
+PackBuilder_insert_tree(PackBuilder *self, PyObject *py_oid)
+{
+    int err;
+    git_oid oid;
+
+    err = py_oid_to_git_oid_expand(self->repo->repo, py_oid, &oid);
+    if (err < 0)
+        return NULL;
+
+    err = git_packbuilder_insert_tree(self->pb, &oid);
+    if (err < 0)
+        return Error_set(err);
+
+    Py_RETURN_NONE;
+}
+
+
+PyDoc_STRVAR(PackBuilder_write__doc__,
+  "write(path)\n"
+  "\n"
+  "Write the pack (and its index) to the given directory. Delta\n"
+  "compression runs with the GIL released, so other Python threads keep\n"
+  "running while the pack is built.");
+
+PyObject *
+PackBuilder_write(PackBuilder *self, PyObject *args)
+{
+    const char *path;
+    int err;
+
+    if (!PyArg_ParseTuple(args, "s", &path))
+        return NULL;
+
+    Py_BEGIN_ALLOW_THREADS
+    err = git_packbuilder_write(self->pb, path);
+    Py_END_ALLOW_THREADS
+    if (err < 0)
+        return Error_set(err);
+
+    Py_RETURN_NONE;
+}
+
+
+PyDoc_STRVAR(PackBuilder_object_count__doc__,
+  "Number of objects the packbuilder will write out.");
+
+PyObject *
+PackBuilder_object_count__get__(PackBuilder *self)
+{
+    return PyLong_FromUnsignedLong(git_packbuilder_object_count(self->pb));
+}
+
+
+PyDoc_STRVAR(PackBuilder_written__doc__,
+  "Number of objects written to the pack so far.");
+
+PyObject *
+PackBuilder_written__get__(PackBuilder *self)
+{
+    return PyLong_FromUnsignedLong(git_packbuilder_written(self->pb));
+}
+
+
+PyMethodDef PackBuilder_methods[] = {
+    METHOD(PackBuilder, insert, METH_O),
+    METHOD(PackBuilder, insert_commit, METH_O),
+    METHOD(PackBuilder, insert_tree, METH_O),
+    METHOD(PackBuilder, set_threads, METH_O),
+    METHOD(PackBuilder, write, METH_VARARGS),
+    {NULL}
+};
+
+PyGetSetDef PackBuilder_getseters[] = {
+    GETTER(PackBuilder, object_count),
+    GETTER(PackBuilder, written),
+    {NULL}
+};
+
+
+PyDoc_STRVAR(PackBuilder__doc__, "Pack builder.");
+
+PyTypeObject PackBuilderType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.PackBuilder",                     /* tp_name           */
+    sizeof(PackBuilder),                       /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)PackBuilder_dealloc,           /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    0,                                         /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    PackBuilder__doc__,                        /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    0,                                         /* tp_iter           */
+    0,                                         /* tp_iternext       */
+    PackBuilder_methods,                       /* tp_methods        */
+    0,                                         /* tp_members        */
+    PackBuilder_getseters,                     /* tp_getset         */
+    0,                                         /* tp_base           */
+    0,                                         /* tp_dict           */
+    0,                                         /* tp_descr_get      */
+    0,                                         /* tp_descr_set      */
+    0,                                         /* tp_dictoffset     */
+    0,                                         /* tp_init           */
+    0,                                         /* tp_alloc          */
+    0,                                         /* tp_new            */
+};
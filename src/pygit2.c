@@ -34,6 +34,7 @@
 #include "utils.h"
 #include "repository.h"
 #include "oid.h"
+#include "instrumentation.h"
 
 extern PyObject *GitError;
 
@@ -43,10 +44,12 @@ extern PyTypeObject ObjectType;
 extern PyTypeObject CommitType;
 extern PyTypeObject DiffType;
 extern PyTypeObject DiffIterType;
+extern PyTypeObject DeltaIterType;
 extern PyTypeObject PatchType;
 extern PyTypeObject HunkType;
 extern PyTypeObject TreeType;
 extern PyTypeObject TreeBuilderType;
+extern PyTypeObject PackBuilderType;
 extern PyTypeObject TreeEntryType;
 extern PyTypeObject TreeIterType;
 extern PyTypeObject BlobType;
@@ -58,6 +61,8 @@ extern PyTypeObject WalkerType;
 extern PyTypeObject ConfigType;
 extern PyTypeObject ReferenceType;
 extern PyTypeObject RefLogIterType;
+extern PyTypeObject RefsIterType;
+extern PyTypeObject BranchesIterType;
 extern PyTypeObject RefLogEntryType;
 extern PyTypeObject BranchType;
 extern PyTypeObject SignatureType;
@@ -232,6 +237,25 @@ hash(PyObject *self, PyObject *args)
 }
 
 
+PyDoc_STRVAR(get_stats__doc__,
+  "get_stats() -> {str: (int, float), ...}\n"
+  "\n"
+  "Return the per-function call counters as a dict mapping the binding\n"
+  "function name to a (calls, total_seconds) tuple. The counters only\n"
+  "advance after enable_stats(True).");
+
+PyDoc_STRVAR(reset_stats__doc__,
+  "reset_stats()\n"
+  "\n"
+  "Reset all the call counters to zero.");
+
+PyDoc_STRVAR(enable_stats__doc__,
+  "enable_stats(enabled)\n"
+  "\n"
+  "Turn the call counters on or off. Disabled counters cost a single\n"
+  "flag check per instrumented call, so the instrumentation can stay\n"
+  "compiled in for production builds.");
+
 PyMethodDef module_methods[] = {
     {"init_repository", init_repository, METH_VARARGS, init_repository__doc__},
     {"clone_repository", clone_repository, METH_VARARGS,
@@ -240,6 +264,10 @@ PyMethodDef module_methods[] = {
      discover_repository__doc__},
     {"hashfile", hashfile, METH_VARARGS, hashfile__doc__},
     {"hash", hash, METH_VARARGS, hash__doc__},
+    {"get_stats", (PyCFunction)get_stats, METH_NOARGS, get_stats__doc__},
+    {"reset_stats", (PyCFunction)reset_stats, METH_NOARGS,
+     reset_stats__doc__},
+    {"enable_stats", (PyCFunction)enable_stats, METH_O, enable_stats__doc__},
     {NULL}
 };
 
@@ -282,6 +310,7 @@ moduleinit(PyObject* m)
     INIT_TYPE(TreeEntryType, NULL, NULL)
     INIT_TYPE(TreeIterType, NULL, NULL)
     INIT_TYPE(TreeBuilderType, NULL, NULL)
+    INIT_TYPE(PackBuilderType, NULL, NULL)
     INIT_TYPE(BlobType, &ObjectType, NULL)
     INIT_TYPE(TagType, &ObjectType, NULL)
     ADD_TYPE(m, Object)
@@ -290,6 +319,7 @@ moduleinit(PyObject* m)
     ADD_TYPE(m, Tree)
     ADD_TYPE(m, TreeEntry)
     ADD_TYPE(m, TreeBuilder)
+    ADD_TYPE(m, PackBuilder)
     ADD_TYPE(m, Blob)
     ADD_TYPE(m, Tag)
     ADD_CONSTANT_INT(m, GIT_OBJ_ANY)
@@ -320,6 +350,8 @@ moduleinit(PyObject* m)
     INIT_TYPE(ReferenceType, NULL, PyType_GenericNew)
     INIT_TYPE(RefLogEntryType, NULL, NULL)
     INIT_TYPE(RefLogIterType, NULL, NULL)
+    INIT_TYPE(RefsIterType, NULL, NULL)
+    INIT_TYPE(BranchesIterType, NULL, NULL)
     INIT_TYPE(NoteType, NULL, NULL)
     INIT_TYPE(NoteIterType, NULL, NULL)
     ADD_TYPE(m, Reference)
@@ -373,6 +405,7 @@ moduleinit(PyObject* m)
      */
     INIT_TYPE(DiffType, NULL, NULL)
     INIT_TYPE(DiffIterType, NULL, NULL)
+    INIT_TYPE(DeltaIterType, NULL, NULL)
     INIT_TYPE(PatchType, NULL, NULL)
     INIT_TYPE(HunkType, NULL, NULL)
     ADD_TYPE(m, Diff)
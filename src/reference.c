@@ -34,6 +34,7 @@
 #include "types.h"
 #include "utils.h"
 #include "oid.h"
+#include "repository.h"
 #include "signature.h"
 #include "reference.h"
 
@@ -57,8 +58,8 @@ PyObject* RefLogIter_iternext(RefLogIter *self)
         entry = git_reflog_entry_byindex(self->reflog, self->i);
         py_entry = PyObject_New(RefLogEntry, &RefLogEntryType);
 
-        py_entry->oid_old = git_oid_allocfmt(git_reflog_entry_id_old(entry));
-        py_entry->oid_new = git_oid_allocfmt(git_reflog_entry_id_new(entry));
+        git_oid_cpy(&py_entry->oid_old, git_reflog_entry_id_old(entry));
+        git_oid_cpy(&py_entry->oid_new, git_reflog_entry_id_new(entry));
         py_entry->message = strdup(git_reflog_entry_message(entry));
         py_entry->signature = git_signature_dup(
             git_reflog_entry_committer(entry));
@@ -105,12 +106,75 @@ PyTypeObject RefLogIterType = {
     (iternextfunc)RefLogIter_iternext,         /* tp_iternext       */
 };
 
+void RefsIter_dealloc(RefsIter *self)
+{
+    git_strarray_free(&self->array);
+    PyObject_Del(self);
+}
+
+PyObject* RefsIter_iternext(RefsIter *self)
+{
+    if (self->i < self->array.count)
+        return to_path(self->array.strings[self->i++]);
+
+    PyErr_SetNone(PyExc_StopIteration);
+    return NULL;
+}
+
+
+PyDoc_STRVAR(RefsIterType__doc__, "Internal reference name iterator object.");
+
+PyTypeObject RefsIterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.RefsIter",                        /* tp_name           */
+    sizeof(RefsIter),                          /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)RefsIter_dealloc,              /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    0,                                         /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,  /* tp_flags          */
+    RefsIterType__doc__,                       /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    PyObject_SelfIter,                         /* tp_iter           */
+    (iternextfunc)RefsIter_iternext,           /* tp_iternext       */
+};
+
 void
 Reference_dealloc(Reference *self)
 {
+    PyObject_GC_UnTrack(self);
     Py_CLEAR(self->repo);
     git_reference_free(self->reference);
-    PyObject_Del(self);
+    PyObject_GC_Del(self);
+}
+
+int
+Reference_traverse(Reference *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->repo);
+    return 0;
+}
+
+int
+Reference_clear(Reference *self)
+{
+    Py_CLEAR(self->repo);
+    return 0;
 }
 
 
@@ -131,6 +195,7 @@ Reference_delete(Reference *self, PyObject *args)
     if (err < 0)
         return Error_set(err);
 
+    Repository_invalidate_ref_caches(self->repo);
     git_reference_free(self->reference);
     self->reference = NULL; /* Invalidate the pointer */
 
@@ -164,6 +229,7 @@ Reference_rename(Reference *self, PyObject *py_name)
     if (err < 0)
         return Error_set(err);
 
+    Repository_invalidate_ref_caches(self->repo);
     self->reference = new_reference;
     Py_RETURN_NONE;
 }
@@ -242,6 +308,7 @@ Reference_target__set__(Reference *self, PyObject *py_target)
         if (err < 0)
             goto error;
 
+        Repository_invalidate_ref_caches(self->repo);
         git_reference_free(self->reference);
         self->reference = new_ref;
         return 0;
@@ -257,6 +324,7 @@ Reference_target__set__(Reference *self, PyObject *py_target)
     if (err < 0)
         goto error;
 
+    Repository_invalidate_ref_caches(self->repo);
     git_reference_free(self->reference);
     self->reference = new_ref;
     return 0;
@@ -358,21 +426,35 @@ RefLogEntry_init(RefLogEntry *self, PyObject *args, PyObject *kwds)
 static void
 RefLogEntry_dealloc(RefLogEntry *self)
 {
-    free(self->oid_old);
-    free(self->oid_new);
     free(self->message);
     git_signature_free(self->signature);
     PyObject_Del(self);
 }
 
+PyDoc_STRVAR(RefLogEntry_oid_new__doc__, "New oid.");
+
+PyObject *
+RefLogEntry_oid_new__get__(RefLogEntry *self)
+{
+    return git_oid_to_py_str(&self->oid_new);
+}
+
+PyDoc_STRVAR(RefLogEntry_oid_old__doc__, "Old oid.");
+
+PyObject *
+RefLogEntry_oid_old__get__(RefLogEntry *self)
+{
+    return git_oid_to_py_str(&self->oid_old);
+}
+
 PyMemberDef RefLogEntry_members[] = {
-    MEMBER(RefLogEntry, oid_new, T_STRING, "New oid."),
-    MEMBER(RefLogEntry, oid_old, T_STRING, "Old oid."),
     MEMBER(RefLogEntry, message, T_STRING, "Message."),
     {NULL}
 };
 
 PyGetSetDef RefLogEntry_getseters[] = {
+    GETTER(RefLogEntry, oid_new),
+    GETTER(RefLogEntry, oid_old),
     GETTER(RefLogEntry, committer),
     {NULL}
 };
@@ -460,10 +542,12 @@ PyTypeObject ReferenceType = {
     0,                                         /* tp_getattro       */
     0,                                         /* tp_setattro       */
     0,                                         /* tp_as_buffer      */
-    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    Py_TPFLAGS_DEFAULT |
+    Py_TPFLAGS_BASETYPE |
+    Py_TPFLAGS_HAVE_GC,                        /* tp_flags          */
     Reference__doc__,                          /* tp_doc            */
-    0,                                         /* tp_traverse       */
-    0,                                         /* tp_clear          */
+    (traverseproc)Reference_traverse,          /* tp_traverse       */
+    (inquiry)Reference_clear,                  /* tp_clear          */
     0,                                         /* tp_richcompare    */
     0,                                         /* tp_weaklistoffset */
     0,                                         /* tp_iter           */
@@ -487,13 +571,12 @@ wrap_reference(git_reference * c_reference, Repository *repo)
 {
     Reference *py_reference=NULL;
 
-    py_reference = PyObject_New(Reference, &ReferenceType);
+    py_reference = PyObject_GC_New(Reference, &ReferenceType);
     if (py_reference) {
         py_reference->reference = c_reference;
-        if (repo) {
-            py_reference->repo = repo;
-            Py_INCREF(repo);
-        }
+        py_reference->repo = repo;
+        Py_XINCREF(repo);
+        PyObject_GC_Track(py_reference);
     }
 
     return (PyObject *)py_reference;
@@ -31,6 +31,7 @@
 #include "error.h"
 #include "utils.h"
 #include "types.h"
+#include "repository.h"
 #include "remote.h"
 
 extern PyObject *GitError;
@@ -163,38 +164,105 @@ Remote_get_refspec(Remote *self, PyObject *value)
 }
 
 
+struct fetch_progress_s {
+    PyObject *callback;
+    unsigned int received_objects;
+    unsigned int indexed_objects;
+    int error;
+};
+
+static int
+fetch_progress_cb(const git_transfer_progress *stats, void *data)
+{
+    struct fetch_progress_s *payload = (struct fetch_progress_s *)data;
+    PyGILState_STATE gil;
+    PyObject *result;
+
+    /* Throttle: the transport reports progress for every data chunk,
+     * only bother Python when the object counts move. */
+    if (stats->received_objects == payload->received_objects &&
+        stats->indexed_objects == payload->indexed_objects)
+        return 0;
+
+    payload->received_objects = stats->received_objects;
+    payload->indexed_objects = stats->indexed_objects;
+
+    gil = PyGILState_Ensure();
+    result = PyObject_CallFunction(payload->callback, "IIn",
+                                   stats->received_objects,
+                                   stats->indexed_objects,
+                                   (Py_ssize_t)stats->received_bytes);
+    if (result == NULL)
+        payload->error = 1;
+    else
+        Py_DECREF(result);
+    PyGILState_Release(gil);
+
+    return payload->error ? GIT_EUSER : 0;
+}
+
 PyDoc_STRVAR(Remote_fetch__doc__,
-  "fetch() -> {'indexed_objects': int, 'received_objects' : int,"
+  "fetch([progress]) -> {'indexed_objects': int, 'received_objects' : int,"
   "            'received_bytesa' : int}\n"
   "\n"
   "Negotiate what objects should be downloaded and download the\n"
-  "packfile with those objects");
+  "packfile with those objects. The GIL is released during the network\n"
+  "transfer, so fetches from several threads overlap on the wire.\n"
+  "\n"
+  "Arguments:\n"
+  "\n"
+  "progress: optional callable invoked as progress(received_objects,\n"
+  "   indexed_objects, received_bytes) whenever the object counts\n"
+  "   change. Raising an exception aborts the fetch.");
 
 PyObject *
-Remote_fetch(Remote *self, PyObject *args)
+Remote_fetch(Remote *self, PyObject *args, PyObject *kwds)
 {
-    PyObject* py_stats = NULL;
+    PyObject *py_stats = NULL;
+    PyObject *py_progress = NULL;
     const git_transfer_progress *stats;
+    struct fetch_progress_s progress = {NULL, 0, 0, 0};
     int err;
+    char *keywords[] = {"progress", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", keywords,
+                                     &py_progress))
+        return NULL;
 
+    if (py_progress != NULL && py_progress != Py_None) {
+        if (!PyCallable_Check(py_progress)) {
+            PyErr_SetString(PyExc_TypeError, "progress must be callable");
+            return NULL;
+        }
+        progress.callback = py_progress;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
     err = git_remote_connect(self->remote, GIT_DIRECTION_FETCH);
     if (err == GIT_OK) {
-        err = git_remote_download(self->remote, NULL, NULL);
-        if (err == GIT_OK) {
-            stats = git_remote_stats(self->remote);
-            py_stats = Py_BuildValue("{s:I,s:I,s:n}",
-                "indexed_objects", stats->indexed_objects,
-                "received_objects", stats->received_objects,
-                "received_bytes", stats->received_bytes);
-
+        err = git_remote_download(self->remote,
+                progress.callback ? fetch_progress_cb : NULL,
+                progress.callback ? &progress : NULL);
+        if (err == GIT_OK)
             err = git_remote_update_tips(self->remote);
-        }
         git_remote_disconnect(self->remote);
     }
+    Py_END_ALLOW_THREADS
 
+    if (err == GIT_EUSER)
+        return NULL;
     if (err < 0)
         return Error_set(err);
 
+    /* Updating the tips writes the remote-tracking references */
+    Repository_invalidate_ref_caches(self->repo);
+
+    stats = git_remote_stats(self->remote);
+    py_stats = Py_BuildValue("{s:I,s:I,s:n}",
+        "indexed_objects", stats->indexed_objects,
+        "received_objects", stats->received_objects,
+        "received_bytes", stats->received_bytes);
+
     return (PyObject*) py_stats;
 }
 
@@ -274,6 +342,7 @@ Remote_push(Remote *self, PyObject *args)
     if (err < 0)
         goto error;
 
+    Repository_invalidate_ref_caches(self->repo);
     git_push_free(push);
     Py_RETURN_NONE;
 
@@ -284,7 +353,7 @@ error:
 
 
 PyMethodDef Remote_methods[] = {
-    METHOD(Remote, fetch, METH_NOARGS),
+    METHOD(Remote, fetch, METH_VARARGS | METH_KEYWORDS),
     METHOD(Remote, save, METH_NOARGS),
     METHOD(Remote, get_refspec, METH_O),
     METHOD(Remote, push, METH_VARARGS),
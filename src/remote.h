@@ -34,6 +34,6 @@
 #include <git2/remote.h>
 
 PyObject* Remote_init(Remote *self, PyObject *args, PyObject *kwds);
-PyObject* Remote_fetch(Remote *self, PyObject *args);
+PyObject* Remote_fetch(Remote *self, PyObject *args, PyObject *kwds);
 
 #endif
@@ -37,6 +37,7 @@
 #include "repository.h"
 #include "remote.h"
 #include "branch.h"
+#include "instrumentation.h"
 #include <git2/odb_backend.h>
 
 extern PyObject *GitError;
@@ -48,10 +49,13 @@ extern PyTypeObject ObjectType;
 extern PyTypeObject CommitType;
 extern PyTypeObject TreeType;
 extern PyTypeObject TreeBuilderType;
+extern PyTypeObject PackBuilderType;
 extern PyTypeObject ConfigType;
 extern PyTypeObject DiffType;
 extern PyTypeObject RemoteType;
 extern PyTypeObject ReferenceType;
+extern PyTypeObject RefsIterType;
+extern PyTypeObject BranchesIterType;
 extern PyTypeObject NoteType;
 extern PyTypeObject NoteIterType;
 
@@ -82,7 +86,9 @@ Repository_init(Repository *self, PyObject *args, PyObject *kwds)
     if (!PyArg_ParseTuple(args, "s", &path))
         return -1;
 
+    Py_BEGIN_ALLOW_THREADS
     err = git_repository_open(&self->repo, path);
+    Py_END_ALLOW_THREADS
     if (err < 0) {
         Error_set_str(err, path);
         return -1;
@@ -90,6 +96,11 @@ Repository_init(Repository *self, PyObject *args, PyObject *kwds)
 
     self->config = NULL;
     self->index = NULL;
+    self->object_cache = NULL;
+    self->object_cache_size = 0;
+    self->head_cache = NULL;
+    self->revparse_cache = NULL;
+    self->revparse_cache_size = 0;
 
     return 0;
 }
@@ -100,6 +111,9 @@ Repository_dealloc(Repository *self)
     PyObject_GC_UnTrack(self);
     Py_CLEAR(self->index);
     Py_CLEAR(self->config);
+    Py_CLEAR(self->object_cache);
+    Py_CLEAR(self->head_cache);
+    Py_CLEAR(self->revparse_cache);
     git_repository_free(self->repo);
     PyObject_GC_Del(self);
 }
@@ -108,6 +122,9 @@ int
 Repository_traverse(Repository *self, visitproc visit, void *arg)
 {
     Py_VISIT(self->index);
+    Py_VISIT(self->object_cache);
+    Py_VISIT(self->head_cache);
+    Py_VISIT(self->revparse_cache);
     return 0;
 }
 
@@ -115,6 +132,9 @@ int
 Repository_clear(Repository *self)
 {
     Py_CLEAR(self->index);
+    Py_CLEAR(self->object_cache);
+    Py_CLEAR(self->head_cache);
+    Py_CLEAR(self->revparse_cache);
     return 0;
 }
 
@@ -152,7 +172,8 @@ Repository_as_iter(Repository *self)
 
 
 PyDoc_STRVAR(Repository_head__doc__,
-  "Current head reference of the repository.");
+  "Current head reference of the repository. The reference is cached,\n"
+  "call invalidate_refs() if HEAD is changed from outside pygit2.");
 
 PyObject *
 Repository_head__get__(Repository *self)
@@ -160,6 +181,11 @@ Repository_head__get__(Repository *self)
     git_reference *head;
     int err;
 
+    if (self->head_cache != NULL) {
+        Py_INCREF(self->head_cache);
+        return self->head_cache;
+    }
+
     err = git_repository_head(&head, self->repo);
     if (err < 0) {
         if (err == GIT_ENOTFOUND)
@@ -170,7 +196,9 @@ Repository_head__get__(Repository *self)
         return NULL;
     }
 
-    return wrap_reference(head, self);
+    self->head_cache = wrap_reference(head, self);
+    Py_XINCREF(self->head_cache);
+    return self->head_cache;
 }
 
 int
@@ -190,10 +218,37 @@ Repository_head__set__(Repository *self, PyObject *py_refname)
         return -1;
     }
 
+    Repository_invalidate_ref_caches(self);
     return 0;
 }
 
 
+/* Every path which writes a reference must call this, the cached head
+ * reference and spec resolutions are snapshots. */
+void
+Repository_invalidate_ref_caches(Repository *self)
+{
+    Py_CLEAR(self->head_cache);
+    if (self->revparse_cache != NULL)
+        PyDict_Clear(self->revparse_cache);
+}
+
+PyDoc_STRVAR(Repository_invalidate_refs__doc__,
+  "invalidate_refs()\n"
+  "\n"
+  "Drop the cached head reference and the cached revision spec\n"
+  "resolutions. References changed through pygit2 do this on their own,\n"
+  "call it when references are changed from outside (e.g. by running\n"
+  "git) and a fresh resolution is needed.");
+
+PyObject *
+Repository_invalidate_refs(Repository *self)
+{
+    Repository_invalidate_ref_caches(self);
+    Py_RETURN_NONE;
+}
+
+
 PyDoc_STRVAR(Repository_head_is_detached__doc__,
   "A repository's HEAD is detached when it points directly to a commit\n"
   "instead of a branch.");
@@ -248,6 +303,190 @@ Repository_is_bare__get__(Repository *self)
 }
 
 
+/* The cache is best effort, a failure to consult or fill it must not turn
+ * into a failed lookup. */
+PyObject *
+Repository_cache_get(Repository *self, const git_oid *oid)
+{
+    PyObject *py_oid, *py_obj;
+
+    if (self->object_cache == NULL)
+        return NULL;
+
+    py_oid = git_oid_to_python(oid);
+    if (py_oid == NULL) {
+        PyErr_Clear();
+        return NULL;
+    }
+
+    py_obj = PyDict_GetItem(self->object_cache, py_oid);
+    Py_DECREF(py_oid);
+    Py_XINCREF(py_obj);
+    return py_obj;
+}
+
+void
+Repository_cache_put(Repository *self, Object *py_obj)
+{
+    PyObject *py_oid;
+
+    if (self->object_cache == NULL || py_obj == NULL)
+        return;
+
+    /* Poor man's eviction: once the cache fills up drop it wholesale,
+     * this keeps the bound without the bookkeeping of a true LRU. */
+    if (PyDict_Size(self->object_cache) >= self->object_cache_size)
+        PyDict_Clear(self->object_cache);
+
+    py_oid = git_oid_to_python(git_object_id(py_obj->obj));
+    if (py_oid == NULL) {
+        PyErr_Clear();
+        return;
+    }
+
+    if (PyDict_SetItem(self->object_cache, py_oid, (PyObject*)py_obj) < 0)
+        PyErr_Clear();
+    Py_DECREF(py_oid);
+}
+
+PyDoc_STRVAR(Repository_object_cache_size__doc__,
+  "Maximum number of objects kept in the in-process object cache.\n"
+  "The cache maps full oids to the objects already wrapped for them, so\n"
+  "repeated lookups of hot objects skip the object database. It is\n"
+  "disabled by default, set a positive size to enable it, set it to 0 to\n"
+  "disable it again and drop the cached objects.");
+
+PyObject *
+Repository_object_cache_size__get__(Repository *self)
+{
+    return PyLong_FromSsize_t(self->object_cache_size);
+}
+
+int
+Repository_object_cache_size__set__(Repository *self, PyObject *py_size)
+{
+    Py_ssize_t size;
+
+    size = PyNumber_AsSsize_t(py_size, PyExc_OverflowError);
+    if (size == -1 && PyErr_Occurred())
+        return -1;
+
+    if (size < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "cache size must not be negative");
+        return -1;
+    }
+
+    if (size == 0) {
+        Py_CLEAR(self->object_cache);
+    }
+    else if (self->object_cache == NULL) {
+        self->object_cache = PyDict_New();
+        if (self->object_cache == NULL)
+            return -1;
+    }
+    else if (PyDict_Size(self->object_cache) > size) {
+        PyDict_Clear(self->object_cache);
+    }
+
+    self->object_cache_size = size;
+    return 0;
+}
+
+
+/* Like the object cache this one is best effort, any failure falls back
+ * to a regular revision parse. */
+static PyObject *
+revparse_cache_get(Repository *self, PyObject *py_spec)
+{
+    PyObject *py_oid;
+    git_object *obj;
+    int err;
+
+    if (self->revparse_cache == NULL)
+        return NULL;
+
+    py_oid = PyDict_GetItem(self->revparse_cache, py_spec);
+    if (py_oid == NULL)
+        return NULL;
+
+    err = git_object_lookup(&obj, self->repo, &((Oid*)py_oid)->oid,
+                            GIT_OBJ_ANY);
+    if (err < 0)
+        return NULL;
+
+    return wrap_object(obj, self);
+}
+
+static void
+revparse_cache_put(Repository *self, PyObject *py_spec, const git_oid *oid)
+{
+    PyObject *py_oid;
+
+    if (self->revparse_cache == NULL)
+        return;
+
+    /* Same wholesale eviction as the object cache */
+    if (PyDict_Size(self->revparse_cache) >= self->revparse_cache_size)
+        PyDict_Clear(self->revparse_cache);
+
+    py_oid = git_oid_to_python(oid);
+    if (py_oid == NULL) {
+        PyErr_Clear();
+        return;
+    }
+
+    if (PyDict_SetItem(self->revparse_cache, py_spec, py_oid) < 0)
+        PyErr_Clear();
+    Py_DECREF(py_oid);
+}
+
+PyDoc_STRVAR(Repository_revparse_cache_size__doc__,
+  "Maximum number of entries kept in the revision spec cache.\n"
+  "The cache maps spec strings to the oid they resolved to, so hot\n"
+  "specs (\"HEAD\", branch and tag names) are a dict hit instead of a\n"
+  "repeated parse. It is invalidated together with the head reference,\n"
+  "see invalidate_refs(). Disabled by default, set a positive size to\n"
+  "enable it, set it to 0 to disable it again.");
+
+PyObject *
+Repository_revparse_cache_size__get__(Repository *self)
+{
+    return PyLong_FromSsize_t(self->revparse_cache_size);
+}
+
+int
+Repository_revparse_cache_size__set__(Repository *self, PyObject *py_size)
+{
+    Py_ssize_t size;
+
+    size = PyNumber_AsSsize_t(py_size, PyExc_OverflowError);
+    if (size == -1 && PyErr_Occurred())
+        return -1;
+
+    if (size < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "cache size must not be negative");
+        return -1;
+    }
+
+    if (size == 0) {
+        Py_CLEAR(self->revparse_cache);
+    }
+    else if (self->revparse_cache == NULL) {
+        self->revparse_cache = PyDict_New();
+        if (self->revparse_cache == NULL)
+            return -1;
+    }
+    else if (PyDict_Size(self->revparse_cache) > size) {
+        PyDict_Clear(self->revparse_cache);
+    }
+
+    self->revparse_cache_size = size;
+    return 0;
+}
+
+
 PyDoc_STRVAR(Repository_git_object_lookup_prefix__doc__,
   "git_object_lookup_prefix(oid) -> Object\n"
   "\n"
@@ -260,14 +499,29 @@ Repository_git_object_lookup_prefix(Repository *self, PyObject *key)
     size_t len;
     git_oid oid;
     git_object *obj;
+    PyObject *py_obj;
+    STATS_START(t);
 
     len = py_oid_to_git_oid(key, &oid);
     if (len == 0)
         return NULL;
 
+    /* Only full oids are cached, a prefix may become ambiguous later */
+    if (len == GIT_OID_HEXSZ) {
+        py_obj = Repository_cache_get(self, &oid);
+        if (py_obj != NULL) {
+            STATS_END(STATS_REPOSITORY_LOOKUP, t);
+            return py_obj;
+        }
+    }
+
+    /* wrap_object takes care of filling the cache */
     err = git_object_lookup_prefix(&obj, self->repo, &oid, len, GIT_OBJ_ANY);
-    if (err == 0)
-        return wrap_object(obj, self);
+    if (err == 0) {
+        py_obj = wrap_object(obj, self);
+        STATS_END(STATS_REPOSITORY_LOOKUP, t);
+        return py_obj;
+    }
 
     if (err == GIT_ENOTFOUND)
         Py_RETURN_NONE;
@@ -315,14 +569,20 @@ Repository_revparse_single(Repository *self, PyObject *py_spec)
 {
     git_object *c_obj;
     char *c_spec;
+    PyObject *py_obj;
     int err;
 
-    /* 1- Get the C revision spec */
+    /* 1- Consult the spec cache */
+    py_obj = revparse_cache_get(self, py_spec);
+    if (py_obj != NULL)
+        return py_obj;
+
+    /* 2- Get the C revision spec */
     c_spec = py_str_to_c_str(py_spec, NULL);
     if (c_spec == NULL)
         return NULL;
 
-    /* 2- Lookup */
+    /* 3- Lookup */
     err = git_revparse_single(&c_obj, self->repo, c_spec);
 
     if (err < 0) {
@@ -332,9 +592,82 @@ Repository_revparse_single(Repository *self, PyObject *py_spec)
     }
     free(c_spec);
 
+    revparse_cache_put(self, py_spec, git_object_id(c_obj));
     return wrap_object(c_obj, self);
 }
 
+
+PyDoc_STRVAR(Repository_revparse_many__doc__,
+  "revparse_many(specs) -> list of Objects\n"
+  "\n"
+  "Resolve a list of revision strings in a single call, returning the\n"
+  "objects in the same order. See revparse_single() for the accepted\n"
+  "syntax.");
+
+PyObject *
+Repository_revparse_many(Repository *self, PyObject *py_specs)
+{
+    PyObject *list, *py_obj;
+    Py_ssize_t len, i;
+
+    if (!PyList_Check(py_specs)) {
+        PyErr_SetString(PyExc_TypeError, "specs must be a list");
+        return NULL;
+    }
+
+    len = PyList_GET_SIZE(py_specs);
+    list = PyList_New(len);
+    if (list == NULL)
+        return NULL;
+
+    for (i = 0; i < len; i++) {
+        py_obj = Repository_revparse_single(self,
+                                            PyList_GET_ITEM(py_specs, i));
+        if (py_obj == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, py_obj);
+    }
+
+    return list;
+}
+
+
+PyDoc_STRVAR(Repository_peel__doc__,
+  "peel(oid, target_type) -> Object\n"
+  "\n"
+  "Look up the object with the given oid and peel it until an object of\n"
+  "the given target type is found, building a wrapper only for the final\n"
+  "object. See Object.peel().");
+
+PyObject *
+Repository_peel(Repository *self, PyObject *args)
+{
+    PyObject *py_oid;
+    int type, err;
+    git_oid oid;
+    git_object *obj, *peeled;
+
+    if (!PyArg_ParseTuple(args, "Oi", &py_oid, &type))
+        return NULL;
+
+    err = py_oid_to_git_oid_expand(self->repo, py_oid, &oid);
+    if (err < 0)
+        return NULL;
+
+    err = git_object_lookup(&obj, self->repo, &oid, GIT_OBJ_ANY);
+    if (err < 0)
+        return Error_set(err);
+
+    err = git_object_peel(&peeled, obj, type);
+    git_object_free(obj);
+    if (err < 0)
+        return Error_set(err);
+
+    return wrap_object(peeled, self);
+}
+
 git_odb_object *
 Repository_read_raw(git_repository *repo, const git_oid *oid, size_t len)
 {
@@ -348,7 +681,9 @@ Repository_read_raw(git_repository *repo, const git_oid *oid, size_t len)
         return NULL;
     }
 
+    Py_BEGIN_ALLOW_THREADS
     err = git_odb_read_prefix(&obj, odb, oid, (unsigned int)len);
+    Py_END_ALLOW_THREADS
     git_odb_free(odb);
     if (err < 0) {
         Error_set_oid(err, oid, len);
@@ -371,6 +706,7 @@ Repository_read(Repository *self, PyObject *py_hex)
     git_odb_object *obj;
     size_t len;
     PyObject* tuple;
+    STATS_START(t);
 
     len = py_oid_to_git_oid(py_hex, &oid);
     if (len == 0)
@@ -391,10 +727,122 @@ Repository_read(Repository *self, PyObject *py_hex)
         git_odb_object_size(obj));
 
     git_odb_object_free(obj);
+    STATS_END(STATS_REPOSITORY_READ, t);
     return tuple;
 }
 
 
+PyDoc_STRVAR(Repository_read_multi__doc__,
+  "read_multi(oids[, max_size]) -> [(Oid, type, data, size), ...]\n"
+  "\n"
+  "Read raw object data for a whole batch of oids in one call, the odb\n"
+  "is opened once and the reads run without the GIL. Returns a list with\n"
+  "one (oid, type, data, size) tuple per object, in the same order the\n"
+  "oids were given. If max_size is given, data is None for objects\n"
+  "bigger than that, only their type and size are reported.");
+
+PyObject *
+Repository_read_multi(Repository *self, PyObject *args, PyObject *kwds)
+{
+    git_odb *odb = NULL;
+    git_oid *oids = NULL;
+    size_t *lens = NULL;
+    git_odb_object **objs = NULL;
+    PyObject *py_oids, *py_result = NULL, *py_tuple, *py_data;
+    Py_ssize_t max_size = -1;
+    Py_ssize_t n, i, failed = -1;
+    size_t size;
+    int err;
+    char *keywords[] = {"oids", "max_size", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!|n", keywords,
+                                     &PyList_Type, &py_oids, &max_size))
+        return NULL;
+
+    n = PyList_Size(py_oids);
+    if (n == 0)
+        return PyList_New(0);
+
+    oids = malloc(n * sizeof(git_oid));
+    lens = malloc(n * sizeof(size_t));
+    objs = calloc(n, sizeof(git_odb_object*));
+    if (oids == NULL || lens == NULL || objs == NULL) {
+        PyErr_SetNone(PyExc_MemoryError);
+        goto out;
+    }
+
+    for (i = 0; i < n; i++) {
+        lens[i] = py_oid_to_git_oid(PyList_GET_ITEM(py_oids, i), &oids[i]);
+        if (lens[i] == 0)
+            goto out;
+    }
+
+    err = git_repository_odb(&odb, self->repo);
+    if (err < 0) {
+        Error_set(err);
+        goto out;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < n; i++) {
+        err = git_odb_read_prefix(&objs[i], odb, &oids[i],
+                                  (unsigned int)lens[i]);
+        if (err < 0) {
+            failed = i;
+            break;
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    if (failed >= 0) {
+        Error_set_oid(err, &oids[failed], lens[failed]);
+        goto out;
+    }
+
+    py_result = PyList_New(n);
+    if (py_result == NULL)
+        goto out;
+
+    for (i = 0; i < n; i++) {
+        size = git_odb_object_size(objs[i]);
+
+        if (max_size >= 0 && size > (size_t)max_size) {
+            py_data = Py_None;
+            Py_INCREF(py_data);
+        } else {
+            py_data = PyBytes_FromStringAndSize(
+                git_odb_object_data(objs[i]), size);
+            if (py_data == NULL) {
+                Py_CLEAR(py_result);
+                goto out;
+            }
+        }
+
+        py_tuple = Py_BuildValue("(NnNn)",
+            git_oid_to_python(git_odb_object_id(objs[i])),
+            (Py_ssize_t)git_odb_object_type(objs[i]),
+            py_data,
+            (Py_ssize_t)size);
+        if (py_tuple == NULL) {
+            Py_CLEAR(py_result);
+            goto out;
+        }
+        PyList_SET_ITEM(py_result, i, py_tuple);
+    }
+
+out:
+    if (objs != NULL) {
+        for (i = 0; i < n; i++)
+            git_odb_object_free(objs[i]);
+    }
+    free(objs);
+    free(lens);
+    free(oids);
+    git_odb_free(odb);
+    return py_result;
+}
+
+
 PyDoc_STRVAR(Repository_write__doc__,
     "write(type, data) -> Oid\n"
     "\n"
@@ -430,8 +878,10 @@ Repository_write(Repository *self, PyObject *args)
     if (err < 0)
         return Error_set(err);
 
+    Py_BEGIN_ALLOW_THREADS
     stream->write(stream, buffer, buflen);
     err = stream->finalize_write(&oid, stream);
+    Py_END_ALLOW_THREADS
     stream->free(stream);
     return git_oid_to_python(&oid);
 }
@@ -570,6 +1020,91 @@ Repository_merge_base(Repository *self, PyObject *args)
     return git_oid_to_python(&oid);
 }
 
+PyDoc_STRVAR(Repository_merge_base_many__doc__,
+  "merge_base_many(oids) -> Oid\n"
+  "\n"
+  "Find as good common ancestors as possible for an n-way merge.\n"
+  "Takes a list of oids and does the graph traversal once, instead of\n"
+  "one merge_base() call per pair.");
+
+PyObject *
+Repository_merge_base_many(Repository *self, PyObject *py_oids)
+{
+    git_oid *oids;
+    git_oid oid;
+    Py_ssize_t len, i;
+    int err;
+
+    if (!PyList_Check(py_oids)) {
+        PyErr_SetString(PyExc_TypeError, "oids must be a list");
+        return NULL;
+    }
+
+    len = PyList_GET_SIZE(py_oids);
+    oids = calloc(len, sizeof(git_oid));
+    if (oids == NULL) {
+        PyErr_SetNone(PyExc_MemoryError);
+        return NULL;
+    }
+
+    for (i = 0; i < len; i++) {
+        err = py_oid_to_git_oid_expand(self->repo,
+                                       PyList_GET_ITEM(py_oids, i),
+                                       &oids[i]);
+        if (err < 0) {
+            free(oids);
+            return NULL;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    err = git_merge_base_many(&oid, self->repo, oids, len);
+    Py_END_ALLOW_THREADS
+
+    free(oids);
+    if (err < 0)
+        return Error_set(err);
+
+    return git_oid_to_python(&oid);
+}
+
+PyDoc_STRVAR(Repository_ahead_behind__doc__,
+  "ahead_behind(local, upstream) -> (int, int)\n"
+  "\n"
+  "Calculate how many different commits are in the non-common parts of\n"
+  "the history between the two given ids. The walk is done once in C\n"
+  "with the GIL released.");
+
+PyObject *
+Repository_ahead_behind(Repository *self, PyObject *args)
+{
+    PyObject *value1;
+    PyObject *value2;
+    git_oid oid1;
+    git_oid oid2;
+    size_t ahead, behind;
+    int err;
+
+    if (!PyArg_ParseTuple(args, "OO", &value1, &value2))
+        return NULL;
+
+    err = py_oid_to_git_oid_expand(self->repo, value1, &oid1);
+    if (err < 0)
+        return NULL;
+
+    err = py_oid_to_git_oid_expand(self->repo, value2, &oid2);
+    if (err < 0)
+        return NULL;
+
+    Py_BEGIN_ALLOW_THREADS
+    err = git_graph_ahead_behind(&ahead, &behind, self->repo, &oid1, &oid2);
+    Py_END_ALLOW_THREADS
+    if (err < 0)
+        return Error_set(err);
+
+    return Py_BuildValue("(nn)", (Py_ssize_t)ahead, (Py_ssize_t)behind);
+}
+
 PyDoc_STRVAR(Repository_walk__doc__,
   "walk(oid, sort_mode) -> iterator\n"
   "\n"
@@ -670,6 +1205,184 @@ Repository_create_blob(Repository *self, PyObject *args)
 }
 
 
+PyDoc_STRVAR(Repository_create_blobs__doc__,
+    "create_blobs(blobs) -> [Oid, ...]\n"
+    "\n"
+    "Create blobs from an iterable of bytes strings and add them to the\n"
+    "object database. All the writes are done in one C loop with the GIL\n"
+    "released. Returns the oids of the blobs, in the same order.");
+
+PyObject *
+Repository_create_blobs(Repository *self, PyObject *py_buffers)
+{
+    PyObject *py_items, *py_result = NULL;
+    git_oid *oids = NULL;
+    const char **bufs = NULL;
+    Py_ssize_t *sizes = NULL;
+    Py_ssize_t n, i;
+    char *buf;
+    int err = 0;
+
+    /* Drain the iterable first, so the writes can run in a single loop
+     * without the GIL. The list keeps the buffers alive meanwhile. */
+    py_items = PySequence_Fast(py_buffers,
+                               "blobs must be an iterable of bytes");
+    if (py_items == NULL)
+        return NULL;
+
+    n = PySequence_Fast_GET_SIZE(py_items);
+    if (n == 0) {
+        Py_DECREF(py_items);
+        return PyList_New(0);
+    }
+
+    oids = malloc(n * sizeof(git_oid));
+    bufs = malloc(n * sizeof(char*));
+    sizes = malloc(n * sizeof(Py_ssize_t));
+    if (oids == NULL || bufs == NULL || sizes == NULL) {
+        PyErr_SetNone(PyExc_MemoryError);
+        goto out;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (PyBytes_AsStringAndSize(PySequence_Fast_GET_ITEM(py_items, i),
+                                    &buf, &sizes[i]) < 0)
+            goto out;
+        bufs[i] = buf;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < n; i++) {
+        err = git_blob_create_frombuffer(&oids[i], self->repo,
+                                         (const void*)bufs[i], sizes[i]);
+        if (err < 0)
+            break;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (err < 0) {
+        Error_set(err);
+        goto out;
+    }
+
+    py_result = PyList_New(n);
+    if (py_result == NULL)
+        goto out;
+
+    for (i = 0; i < n; i++)
+        PyList_SET_ITEM(py_result, i, git_oid_to_python(&oids[i]));
+
+out:
+    free(sizes);
+    free(bufs);
+    free(oids);
+    Py_DECREF(py_items);
+    return py_result;
+}
+
+
+/* State shared with read_chunk_cb, see create_blob_fromstream */
+struct blob_stream_s {
+    PyObject *read;
+    size_t chunk_size;
+    int error;
+};
+
+static int
+read_chunk_cb(char *content, size_t max_length, void *payload)
+{
+    struct blob_stream_s *stream = (struct blob_stream_s *)payload;
+    PyObject *py_chunk;
+    char *buf;
+    Py_ssize_t size;
+    PyGILState_STATE arbiter;
+    int read = -1;
+
+    if (stream->error)
+        return -1;
+
+    if (max_length > stream->chunk_size)
+        max_length = stream->chunk_size;
+
+    arbiter = PyGILState_Ensure();
+
+    py_chunk = PyObject_CallFunction(stream->read, "n",
+                                     (Py_ssize_t)max_length);
+    if (py_chunk == NULL)
+        goto error;
+
+    if (PyBytes_AsStringAndSize(py_chunk, &buf, &size) < 0) {
+        Py_DECREF(py_chunk);
+        goto error;
+    }
+
+    if ((size_t)size > max_length) {
+        PyErr_SetString(PyExc_ValueError,
+                        "read() returned more bytes than requested");
+        Py_DECREF(py_chunk);
+        goto error;
+    }
+
+    /* An empty read means end of stream */
+    memcpy(content, buf, size);
+    read = (int)size;
+    Py_DECREF(py_chunk);
+    goto out;
+
+error:
+    stream->error = 1;
+out:
+    PyGILState_Release(arbiter);
+    return read;
+}
+
+PyDoc_STRVAR(Repository_create_blob_fromstream__doc__,
+    "create_blob_fromstream(fileobj[, chunk_size]) -> Oid\n"
+    "\n"
+    "Create a new blob from a file-like object, reading chunk_size bytes\n"
+    "at a time (1 MiB by default). The data goes straight from fileobj\n"
+    "into the object database, so memory use stays bounded no matter how\n"
+    "big the blob is. The GIL is held only while a chunk is read.");
+
+PyObject *
+Repository_create_blob_fromstream(Repository *self, PyObject *args)
+{
+    git_oid oid;
+    PyObject *py_file;
+    Py_ssize_t chunk_size = 1 << 20;
+    struct blob_stream_s stream;
+    int err;
+
+    if (!PyArg_ParseTuple(args, "O|n", &py_file, &chunk_size))
+        return NULL;
+
+    if (chunk_size <= 0) {
+        PyErr_SetString(PyExc_ValueError, "chunk_size must be positive");
+        return NULL;
+    }
+
+    stream.read = PyObject_GetAttrString(py_file, "read");
+    if (stream.read == NULL)
+        return NULL;
+    stream.chunk_size = (size_t)chunk_size;
+    stream.error = 0;
+
+    Py_BEGIN_ALLOW_THREADS
+    err = git_blob_create_fromchunks(&oid, self->repo, NULL, read_chunk_cb,
+                                     &stream);
+    Py_END_ALLOW_THREADS
+
+    Py_DECREF(stream.read);
+
+    if (stream.error)
+        return NULL;
+    if (err < 0)
+        return Error_set(err);
+
+    return git_oid_to_python(&oid);
+}
+
+
 PyDoc_STRVAR(Repository_create_blob_fromworkdir__doc__,
     "create_blob_fromworkdir(path) -> Oid\n"
     "\n"
@@ -707,14 +1420,85 @@ Repository_create_blob_fromdisk(Repository *self, PyObject *args)
     const char* path;
     int err;
 
-    if (!PyArg_ParseTuple(args, "s", &path))
-        return NULL;
+    if (!PyArg_ParseTuple(args, "s", &path))
+        return NULL;
+
+    err = git_blob_create_fromdisk(&oid, self->repo, path);
+    if (err < 0)
+        return Error_set(err);
+
+    return git_oid_to_python(&oid);
+}
+
+
+PyDoc_STRVAR(Repository_create_blobs_fromdisk__doc__,
+    "create_blobs_fromdisk(paths) -> [Oid, ...]\n"
+    "\n"
+    "Create blobs from a list of files anywhere in the file system, the\n"
+    "reads and writes are done in one C loop with the GIL released.\n"
+    "Returns the oids of the blobs, in the same order.");
+
+PyObject *
+Repository_create_blobs_fromdisk(Repository *self, PyObject *py_paths)
+{
+    PyObject *py_result = NULL;
+    git_oid *oids = NULL;
+    char **paths = NULL;
+    Py_ssize_t n, i, failed = -1;
+    int err = 0;
+
+    if (!PyList_Check(py_paths)) {
+        PyErr_SetString(PyExc_TypeError, "paths must be a list");
+        return NULL;
+    }
+
+    n = PyList_Size(py_paths);
+    if (n == 0)
+        return PyList_New(0);
+
+    oids = malloc(n * sizeof(git_oid));
+    paths = calloc(n, sizeof(char*));
+    if (oids == NULL || paths == NULL) {
+        PyErr_SetNone(PyExc_MemoryError);
+        goto out;
+    }
+
+    for (i = 0; i < n; i++) {
+        paths[i] = py_path_to_c_str(PyList_GET_ITEM(py_paths, i));
+        if (paths[i] == NULL)
+            goto out;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < n; i++) {
+        err = git_blob_create_fromdisk(&oids[i], self->repo, paths[i]);
+        if (err < 0) {
+            failed = i;
+            break;
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    if (err < 0) {
+        Error_set_str(err, paths[failed]);
+        goto out;
+    }
+
+    py_result = PyList_New(n);
+    if (py_result == NULL)
+        goto out;
 
-    err = git_blob_create_fromdisk(&oid, self->repo, path);
-    if (err < 0)
-        return Error_set(err);
+    for (i = 0; i < n; i++)
+        PyList_SET_ITEM(py_result, i, git_oid_to_python(&oids[i]));
 
-    return git_oid_to_python(&oid);
+out:
+    if (paths != NULL) {
+        for (i = 0; i < n; i++)
+            free(paths[i]);
+    }
+    free(paths);
+    free(oids);
+    return py_result;
 }
 
 
@@ -790,6 +1574,9 @@ Repository_create_commit(Repository *self, PyObject *args)
         goto out;
     }
 
+    if (update_ref != NULL)
+        Repository_invalidate_ref_caches(self);
+
     py_result = git_oid_to_python(&oid);
 
 out:
@@ -839,6 +1626,8 @@ Repository_create_tag(Repository *self, PyObject *args)
     git_object_free(target);
     if (err < 0)
         return Error_set_oid(err, &oid, len);
+
+    Repository_invalidate_ref_caches(self);
     return git_oid_to_python(&oid);
 }
 
@@ -872,6 +1661,7 @@ PyObject* Repository_create_branch(Repository *self, PyObject *args)
     if (err < 0)
         return Error_set(err);
 
+    Repository_invalidate_ref_caches(self);
     return wrap_branch(c_reference, self);
 }
 
@@ -915,6 +1705,40 @@ out:
 }
 
 
+PyDoc_STRVAR(Repository_iter_references__doc__,
+  "iter_references() -> iterator over reference names\n"
+  "\n"
+  "Return an iterator which yields the reference names one at a time.\n"
+  "Compared with listall_references() the names are converted to Python\n"
+  "strings lazily, which matters for repositories with very many\n"
+  "references.");
+
+PyObject *
+Repository_iter_references(Repository *self)
+{
+    RefsIter *iter;
+    git_strarray array;
+    int err;
+
+    /* Take the snapshot up front; only the string conversion is lazy. */
+    Py_BEGIN_ALLOW_THREADS
+    err = git_reference_list(&array, self->repo);
+    Py_END_ALLOW_THREADS
+    if (err < 0)
+        return Error_set(err);
+
+    iter = PyObject_New(RefsIter, &RefsIterType);
+    if (iter == NULL) {
+        git_strarray_free(&array);
+        return NULL;
+    }
+
+    iter->array = array;
+    iter->i = 0;
+    return (PyObject*)iter;
+}
+
+
 PyDoc_STRVAR(Repository_listall_branches__doc__,
   "listall_branches([flags]) -> (str, ...)\n"
   "\n"
@@ -986,6 +1810,109 @@ Repository_listall_branches(Repository *self, PyObject *args)
 }
 
 
+struct branches_iter_s {
+    char **names;
+    git_branch_t *types;
+    size_t count;
+    size_t size;
+};
+
+static int
+branches_iter_cb(const char *branch_name, git_branch_t branch_type,
+                 void *payload)
+{
+    /* Stash the branch names in plain C storage, the iterator resolves
+     * them one at a time later. */
+    struct branches_iter_s *branches = (struct branches_iter_s *)payload;
+
+    if (branches->count == branches->size) {
+        size_t size = branches->size ? branches->size * 2 : 64;
+        char **names;
+        git_branch_t *types;
+
+        names = realloc(branches->names, size * sizeof(char*));
+        if (names != NULL)
+            branches->names = names;
+        types = realloc(branches->types, size * sizeof(git_branch_t));
+        if (types != NULL)
+            branches->types = types;
+        if (names == NULL || types == NULL)
+            return GIT_ERROR;
+        branches->size = size;
+    }
+
+    branches->names[branches->count] = strdup(branch_name);
+    if (branches->names[branches->count] == NULL)
+        return GIT_ERROR;
+    branches->types[branches->count] = branch_type;
+    branches->count++;
+
+    return GIT_OK;
+}
+
+static void
+branches_iter_free(struct branches_iter_s *branches)
+{
+    size_t i;
+
+    for (i = 0; i < branches->count; i++)
+        free(branches->names[i]);
+    free(branches->names);
+    free(branches->types);
+}
+
+PyDoc_STRVAR(Repository_iter_branches__doc__,
+  "iter_branches([flags]) -> iterator over (name, target, is_head)\n"
+  "\n"
+  "Return an iterator yielding one lightweight record per branch, from\n"
+  "a single scan of the ref storage. No Branch wrappers are built and a\n"
+  "branch is only resolved to its target when it is yielded, which\n"
+  "makes this much cheaper than listall_branches() plus one\n"
+  "lookup_branch() per name.");
+
+PyObject *
+Repository_iter_branches(Repository *self, PyObject *args)
+{
+    BranchesIter *iter;
+    struct branches_iter_s branches = {NULL, NULL, 0, 0};
+    unsigned int list_flags = GIT_BRANCH_LOCAL;
+    int err;
+
+    if (!PyArg_ParseTuple(args, "|I", &list_flags))
+        return NULL;
+
+    Py_BEGIN_ALLOW_THREADS
+    err = git_branch_foreach(self->repo, list_flags, branches_iter_cb,
+                             &branches);
+    Py_END_ALLOW_THREADS
+
+    if (err != GIT_OK) {
+        branches_iter_free(&branches);
+        /* The callback only fails on oom */
+        if (err == GIT_EUSER || err == GIT_ERROR)
+            PyErr_SetNone(PyExc_MemoryError);
+        else
+            Error_set(err);
+        return NULL;
+    }
+
+    iter = PyObject_New(BranchesIter, &BranchesIterType);
+    if (iter == NULL) {
+        branches_iter_free(&branches);
+        return NULL;
+    }
+
+    iter->repo = self;
+    Py_INCREF(self);
+    iter->names = branches.names;
+    iter->types = branches.types;
+    iter->count = branches.count;
+    iter->i = 0;
+
+    return (PyObject*)iter;
+}
+
+
 PyDoc_STRVAR(Repository_lookup_reference__doc__,
   "lookup_reference(name) -> Reference\n"
   "\n"
@@ -1052,6 +1979,7 @@ Repository_create_reference_direct(Repository *self,  PyObject *args,
     if (err < 0)
         return Error_set(err);
 
+    Repository_invalidate_ref_caches(self);
     return wrap_reference(c_reference, self);
 }
 
@@ -1086,43 +2014,293 @@ Repository_create_reference_symbolic(Repository *self,  PyObject *args,
     if (err < 0)
         return Error_set(err);
 
+    Repository_invalidate_ref_caches(self);
     return wrap_reference(c_reference, self);
 }
 
 
 PyDoc_STRVAR(Repository_status__doc__,
-  "status() -> {str: int}\n"
+  "status([paths, untracked]) -> {str: int}\n"
   "\n"
   "Reads the status of the repository and returns a dictionary with file\n"
-  "paths as keys and status flags as values. See pygit2.GIT_STATUS_*.");
+  "paths as keys and status flags as values. See pygit2.GIT_STATUS_*.\n"
+  "\n"
+  "If a list of paths is given only those matching the pathspecs are\n"
+  "scanned, and setting untracked to False skips the enumeration of\n"
+  "untracked files altogether.");
+
+typedef struct {
+    char **paths;
+    unsigned int *statuses;
+    size_t count;
+    size_t size;
+} StatusEntries;
+
+static void
+status_entries_free(StatusEntries *entries)
+{
+    size_t i;
+
+    for (i = 0; i < entries->count; i++)
+        free(entries->paths[i]);
+    free(entries->paths);
+    free(entries->statuses);
+}
 
 int
 read_status_cb(const char *path, unsigned int status_flags, void *payload)
 {
-    /* This is the callback that will be called in git_status_foreach. It
-     * will be called for every path.*/
-    PyObject *flags;
-    int err;
-
-    flags = PyLong_FromLong((long) status_flags);
-    err = PyDict_SetItemString(payload, path, flags);
-    Py_CLEAR(flags);
+    /* This is the callback that will be called in git_status_foreach_ext.
+     * It is called without the GIL held, so it only stashes the entry in
+     * plain C storage, the result dict is built in one pass afterwards. */
+    StatusEntries *entries = (StatusEntries*)payload;
+
+    if (entries->count == entries->size) {
+        size_t size = (entries->size == 0) ? 64 : entries->size * 2;
+        char **paths;
+        unsigned int *statuses;
+
+        paths = realloc(entries->paths, size * sizeof(char*));
+        if (paths != NULL)
+            entries->paths = paths;
+        statuses = realloc(entries->statuses, size * sizeof(unsigned int));
+        if (statuses != NULL)
+            entries->statuses = statuses;
+        if (paths == NULL || statuses == NULL)
+            return GIT_ERROR;
+        entries->size = size;
+    }
 
-    if (err < 0)
+    entries->paths[entries->count] = strdup(path);
+    if (entries->paths[entries->count] == NULL)
         return GIT_ERROR;
+    entries->statuses[entries->count] = status_flags;
+    entries->count++;
 
     return GIT_OK;
 }
 
 PyObject *
-Repository_status(Repository *self, PyObject *args)
+Repository_status(Repository *self, PyObject *args, PyObject *kwds)
 {
-    PyObject *payload_dict;
+    PyObject *py_paths = NULL;
+    PyObject *py_untracked = NULL;
+    PyObject *payload_dict, *flags;
+    git_status_options opts = GIT_STATUS_OPTIONS_INIT;
+    StatusEntries entries = {NULL, NULL, 0, 0};
+    Py_ssize_t i;
+    int err;
+    char *keywords[] = {"paths", "untracked", NULL};
+    STATS_START(t);
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O!O!", keywords,
+                                     &PyList_Type, &py_paths,
+                                     &PyBool_Type, &py_untracked))
+        return NULL;
+
+    /* These are the flags git_status_foreach runs with, drop the
+     * untracked ones when the caller does not care about them. */
+    opts.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
+    opts.flags = GIT_STATUS_OPT_INCLUDE_IGNORED;
+    if (py_untracked == NULL || py_untracked == Py_True)
+        opts.flags |= GIT_STATUS_OPT_INCLUDE_UNTRACKED |
+                      GIT_STATUS_OPT_RECURSE_UNTRACKED_DIRS;
+
+    if (py_paths != NULL) {
+        opts.pathspec.count = PyList_Size(py_paths);
+        opts.pathspec.strings = calloc(opts.pathspec.count, sizeof(char*));
+        if (opts.pathspec.strings == NULL) {
+            PyErr_SetNone(PyExc_MemoryError);
+            goto error;
+        }
+
+        for (i = 0; i < (Py_ssize_t)opts.pathspec.count; i++) {
+            opts.pathspec.strings[i] =
+                py_path_to_c_str(PyList_GET_ITEM(py_paths, i));
+            if (opts.pathspec.strings[i] == NULL)
+                goto error;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    err = git_status_foreach_ext(self->repo, &opts, read_status_cb,
+                                 &entries);
+    Py_END_ALLOW_THREADS
+
+    git_strarray_free(&opts.pathspec);
+
+    if (err < 0) {
+        status_entries_free(&entries);
+        return Error_set(err);
+    }
 
     payload_dict = PyDict_New();
-    git_status_foreach(self->repo, read_status_cb, payload_dict);
+    if (payload_dict != NULL) {
+        for (i = 0; i < (Py_ssize_t)entries.count; i++) {
+            flags = PyLong_FromLong((long)entries.statuses[i]);
+            if (flags == NULL) {
+                Py_CLEAR(payload_dict);
+                break;
+            }
+            err = PyDict_SetItemString(payload_dict, entries.paths[i],
+                                       flags);
+            Py_CLEAR(flags);
+            if (err < 0) {
+                Py_CLEAR(payload_dict);
+                break;
+            }
+        }
+    }
 
+    status_entries_free(&entries);
+    STATS_END(STATS_REPOSITORY_STATUS, t);
     return payload_dict;
+
+error:
+    git_strarray_free(&opts.pathspec);
+    return NULL;
+}
+
+
+PyDoc_STRVAR(Repository_status_files__doc__,
+  "status_files(paths) -> {path: flags, ...}\n"
+  "\n"
+  "Reads the status of a list of file paths in one pass, sharing the\n"
+  "index load and worktree comparison across the whole batch instead of\n"
+  "paying it per path like status_file(). Paths with nothing to report\n"
+  "map to GIT_STATUS_CURRENT.");
+
+PyObject *
+Repository_status_files(Repository *self, PyObject *py_paths)
+{
+    PyObject *py_result, *py_zero, *flags;
+    git_status_options opts = GIT_STATUS_OPTIONS_INIT;
+    StatusEntries entries = {NULL, NULL, 0, 0};
+    Py_ssize_t i;
+    int err;
+
+    if (!PyList_Check(py_paths)) {
+        PyErr_SetString(PyExc_TypeError, "paths must be a list");
+        return NULL;
+    }
+
+    opts.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
+    opts.flags = GIT_STATUS_OPT_INCLUDE_UNTRACKED |
+                 GIT_STATUS_OPT_INCLUDE_IGNORED |
+                 GIT_STATUS_OPT_INCLUDE_UNMODIFIED |
+                 GIT_STATUS_OPT_RECURSE_UNTRACKED_DIRS;
+
+    opts.pathspec.count = PyList_GET_SIZE(py_paths);
+    opts.pathspec.strings = calloc(opts.pathspec.count, sizeof(char*));
+    if (opts.pathspec.strings == NULL) {
+        PyErr_SetNone(PyExc_MemoryError);
+        return NULL;
+    }
+
+    for (i = 0; i < (Py_ssize_t)opts.pathspec.count; i++) {
+        opts.pathspec.strings[i] =
+            py_path_to_c_str(PyList_GET_ITEM(py_paths, i));
+        if (opts.pathspec.strings[i] == NULL) {
+            git_strarray_free(&opts.pathspec);
+            return NULL;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    err = git_status_foreach_ext(self->repo, &opts, read_status_cb,
+                                 &entries);
+    Py_END_ALLOW_THREADS
+
+    git_strarray_free(&opts.pathspec);
+
+    if (err < 0) {
+        status_entries_free(&entries);
+        return Error_set(err);
+    }
+
+    /* Every requested path starts clean, the entries overwrite */
+    py_result = PyDict_New();
+    py_zero = PyLong_FromLong(0);
+    if (py_result == NULL || py_zero == NULL)
+        goto error;
+
+    for (i = 0; i < PyList_GET_SIZE(py_paths); i++) {
+        if (PyDict_SetItem(py_result, PyList_GET_ITEM(py_paths, i),
+                           py_zero) < 0)
+            goto error;
+    }
+
+    for (i = 0; i < (Py_ssize_t)entries.count; i++) {
+        err = PyDict_GetItemString(py_result, entries.paths[i]) != NULL;
+        if (!err)
+            continue;
+
+        flags = PyLong_FromLong((long)entries.statuses[i]);
+        if (flags == NULL)
+            goto error;
+
+        err = PyDict_SetItemString(py_result, entries.paths[i], flags);
+        Py_DECREF(flags);
+        if (err < 0)
+            goto error;
+    }
+
+    Py_DECREF(py_zero);
+    status_entries_free(&entries);
+    return py_result;
+
+error:
+    Py_XDECREF(py_zero);
+    Py_XDECREF(py_result);
+    status_entries_free(&entries);
+    return NULL;
+}
+
+
+static int
+dirty_status_cb(const char *path, unsigned int status_flags, void *payload)
+{
+    /* Any entry reported at all means the worktree is dirty, stop the
+     * scan right there. */
+    return GIT_EUSER;
+}
+
+PyDoc_STRVAR(Repository_is_dirty__doc__,
+  "is_dirty(untracked=True) -> bool\n"
+  "\n"
+  "Check whether the worktree or the index have any changes. Unlike\n"
+  "status() this stops at the first modified entry, so on a clean or\n"
+  "barely-touched worktree it is much cheaper. Pass untracked=False to\n"
+  "ignore untracked files.");
+
+PyObject *
+Repository_is_dirty(Repository *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *py_untracked = NULL;
+    git_status_options opts = GIT_STATUS_OPTIONS_INIT;
+    int err;
+    char *keywords[] = {"untracked", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O!", keywords,
+                                     &PyBool_Type, &py_untracked))
+        return NULL;
+
+    opts.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
+    opts.flags = 0;
+    if (py_untracked == NULL || py_untracked == Py_True)
+        opts.flags |= GIT_STATUS_OPT_INCLUDE_UNTRACKED |
+                      GIT_STATUS_OPT_RECURSE_UNTRACKED_DIRS;
+
+    Py_BEGIN_ALLOW_THREADS
+    err = git_status_foreach_ext(self->repo, &opts, dirty_status_cb, NULL);
+    Py_END_ALLOW_THREADS
+
+    if (err == GIT_EUSER)
+        Py_RETURN_TRUE;
+    if (err < 0)
+        return Error_set(err);
+
+    Py_RETURN_FALSE;
 }
 
 
@@ -1209,6 +2387,33 @@ Repository_TreeBuilder(Repository *self, PyObject *args)
 }
 
 
+PyDoc_STRVAR(Repository_PackBuilder__doc__,
+  "PackBuilder() -> PackBuilder\n"
+  "\n"
+  "Create a PackBuilder object for this repository.");
+
+PyObject *
+Repository_PackBuilder(Repository *self)
+{
+    PackBuilder *py_builder;
+    git_packbuilder *pb;
+    int err;
+
+    err = git_packbuilder_new(&pb, self->repo);
+    if (err < 0)
+        return Error_set(err);
+
+    py_builder = PyObject_New(PackBuilder, &PackBuilderType);
+    if (py_builder) {
+        py_builder->repo = self;
+        py_builder->pb = pb;
+        Py_INCREF(self);
+    }
+
+    return (PyObject*)py_builder;
+}
+
+
 PyDoc_STRVAR(Repository_create_remote__doc__,
   "create_remote(name, url) -> Remote\n"
   "\n"
@@ -1264,8 +2469,64 @@ Repository_remotes__get__(Repository *self)
 }
 
 
+struct checkout_progress_s {
+    PyObject *callback;
+    size_t last_percent;
+    int error;
+};
+
+/* Deliver the checkout progress to Python, throttled to whole percent
+ * steps so a huge worktree does not mean a Python call per file. */
+static void
+checkout_progress_cb(const char *path, size_t completed_steps,
+                     size_t total_steps, void *data)
+{
+    struct checkout_progress_s *payload = (struct checkout_progress_s *)data;
+    PyGILState_STATE gil;
+    PyObject *result;
+    size_t percent;
+
+    if (payload->error)
+        return;
+
+    percent = total_steps ? completed_steps * 100 / total_steps : 100;
+    if (percent == payload->last_percent &&
+        completed_steps != total_steps)
+        return;
+    payload->last_percent = percent;
+
+    gil = PyGILState_Ensure();
+    result = PyObject_CallFunction(payload->callback, "snn", path,
+                                   (Py_ssize_t)completed_steps,
+                                   (Py_ssize_t)total_steps);
+    if (result == NULL)
+        payload->error = 1;
+    else
+        Py_DECREF(result);
+    PyGILState_Release(gil);
+}
+
+static int
+checkout_progress_init(git_checkout_opts *opts,
+                       struct checkout_progress_s *progress,
+                       PyObject *py_progress)
+{
+    if (py_progress == NULL || py_progress == Py_None)
+        return 0;
+
+    if (!PyCallable_Check(py_progress)) {
+        PyErr_SetString(PyExc_TypeError, "progress must be callable");
+        return -1;
+    }
+
+    progress->callback = py_progress;
+    opts->progress_cb = checkout_progress_cb;
+    opts->progress_payload = progress;
+    return 0;
+}
+
 PyDoc_STRVAR(Repository_checkout_head__doc__,
-    "checkout_head(strategy)\n"
+    "checkout_head(strategy[, progress])\n"
     "\n"
     "Checkout the head using the given strategy.");
 
@@ -1273,14 +2534,23 @@ PyObject *
 Repository_checkout_head(Repository *self, PyObject *args)
 {
     git_checkout_opts opts = GIT_CHECKOUT_OPTS_INIT;
+    struct checkout_progress_s progress = {NULL, (size_t)-1, 0};
+    PyObject *py_progress = NULL;
     unsigned int strategy;
     int err;
 
-    if (!PyArg_ParseTuple(args, "I", &strategy))
+    if (!PyArg_ParseTuple(args, "I|O", &strategy, &py_progress))
+        return NULL;
+
+    if (checkout_progress_init(&opts, &progress, py_progress) < 0)
         return NULL;
 
     opts.checkout_strategy = strategy;
+    Py_BEGIN_ALLOW_THREADS
     err = git_checkout_head(self->repo, &opts);
+    Py_END_ALLOW_THREADS
+    if (progress.error)
+        return NULL;
     if (err < 0)
         return Error_set(err);
 
@@ -1289,7 +2559,7 @@ Repository_checkout_head(Repository *self, PyObject *args)
 
 
 PyDoc_STRVAR(Repository_checkout_index__doc__,
-    "checkout_index(strategy)\n"
+    "checkout_index(strategy[, progress])\n"
     "\n"
     "Checkout the index using the given strategy.");
 
@@ -1297,14 +2567,23 @@ PyObject *
 Repository_checkout_index(Repository *self, PyObject *args)
 {
     git_checkout_opts opts = GIT_CHECKOUT_OPTS_INIT;
+    struct checkout_progress_s progress = {NULL, (size_t)-1, 0};
+    PyObject *py_progress = NULL;
     unsigned int strategy;
     int err;
 
-    if (!PyArg_ParseTuple(args, "I", &strategy))
+    if (!PyArg_ParseTuple(args, "I|O", &strategy, &py_progress))
+        return NULL;
+
+    if (checkout_progress_init(&opts, &progress, py_progress) < 0)
         return NULL;
 
     opts.checkout_strategy = strategy;
+    Py_BEGIN_ALLOW_THREADS
     err = git_checkout_index(self->repo, NULL, &opts);
+    Py_END_ALLOW_THREADS
+    if (progress.error)
+        return NULL;
     if (err < 0)
         return Error_set(err);
 
@@ -1313,7 +2592,7 @@ Repository_checkout_index(Repository *self, PyObject *args)
 
 
 PyDoc_STRVAR(Repository_checkout_tree__doc__,
-    "checkout_tree(treeish, strategy)\n"
+    "checkout_tree(treeish, strategy[, progress])\n"
     "\n"
     "Checkout the given tree, commit or tag, using the given strategy.");
 
@@ -1321,15 +2600,25 @@ PyObject *
 Repository_checkout_tree(Repository *self, PyObject *args)
 {
     git_checkout_opts opts = GIT_CHECKOUT_OPTS_INIT;
+    struct checkout_progress_s progress = {NULL, (size_t)-1, 0};
+    PyObject *py_progress = NULL;
     unsigned int strategy;
     Object *py_object;
     int err;
 
-    if (!PyArg_ParseTuple(args, "O!I", &ObjectType, &py_object, &strategy))
+    if (!PyArg_ParseTuple(args, "O!I|O", &ObjectType, &py_object, &strategy,
+                          &py_progress))
+        return NULL;
+
+    if (checkout_progress_init(&opts, &progress, py_progress) < 0)
         return NULL;
 
     opts.checkout_strategy = strategy;
+    Py_BEGIN_ALLOW_THREADS
     err = git_checkout_tree(self->repo, py_object->obj, &opts);
+    Py_END_ALLOW_THREADS
+    if (progress.error)
+        return NULL;
     if (err < 0)
         return Error_set(err);
 
@@ -1365,6 +2654,161 @@ Repository_notes(Repository *self, PyObject *args)
 }
 
 
+/* One entry of the notes tree stashed while the GIL is released, see
+ * Repository_notes_all. */
+typedef struct {
+    git_oid note_id;
+    git_oid annotated_id;
+    char *message;
+} note_record;
+
+static void
+note_records_free(note_record *records, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++)
+        free(records[i].message);
+    free(records);
+}
+
+PyDoc_STRVAR(Repository_notes_all__doc__,
+  "notes_all([ref, with_messages]) -> [(annotated_id, note_id, message),\n"
+  "                                    ...]\n"
+  "\n"
+  "Read the whole notes tree in one C pass and return one tuple per\n"
+  "note. This is much cheaper than iterating over notes(), which\n"
+  "resolves the notes reference again for every note. Pass\n"
+  "with_messages=False to skip loading the note blobs, the message\n"
+  "element is then None.");
+
+PyObject *
+Repository_notes_all(Repository *self, PyObject *args)
+{
+    git_note_iterator *iter;
+    git_blob *blob;
+    note_record *records = NULL, *tmp;
+    char *ref = "refs/notes/commits";
+    PyObject *py_with_messages = NULL;
+    PyObject *py_result, *py_record, *py_message;
+    size_t count = 0, size = 0, i;
+    int with_messages = 1;
+    int err;
+    int oom = 0;
+
+    if (!PyArg_ParseTuple(args, "|sO", &ref, &py_with_messages))
+        return NULL;
+
+    if (py_with_messages != NULL) {
+        with_messages = PyObject_IsTrue(py_with_messages);
+        if (with_messages < 0)
+            return NULL;
+    }
+
+    err = git_note_iterator_new(&iter, self->repo, ref);
+    if (err < 0)
+        return Error_set(err);
+
+    Py_BEGIN_ALLOW_THREADS
+    for (;;) {
+        git_oid note_id, annotated_id;
+
+        err = git_note_next(&note_id, &annotated_id, iter);
+        if (err < 0)
+            break;
+
+        if (count >= size) {
+            size = size ? size * 2 : 64;
+            tmp = realloc(records, size * sizeof(note_record));
+            if (tmp == NULL) {
+                oom = 1;
+                break;
+            }
+            records = tmp;
+        }
+
+        git_oid_cpy(&records[count].note_id, &note_id);
+        git_oid_cpy(&records[count].annotated_id, &annotated_id);
+        records[count].message = NULL;
+        count++;
+    }
+
+    /* The messages are note blobs, read them straight from the odb
+     * instead of going through git_note_read, which re-resolves the
+     * notes reference every time. */
+    if (!oom && (err == GIT_ITEROVER || err == 0) && with_messages) {
+        for (i = 0; i < count; i++) {
+            git_off_t rawsize;
+
+            err = git_blob_lookup(&blob, self->repo, &records[i].note_id);
+            if (err < 0)
+                break;
+
+            rawsize = git_blob_rawsize(blob);
+            records[i].message = malloc(rawsize + 1);
+            if (records[i].message == NULL) {
+                git_blob_free(blob);
+                oom = 1;
+                break;
+            }
+            memcpy(records[i].message, git_blob_rawcontent(blob), rawsize);
+            records[i].message[rawsize] = '\0';
+            git_blob_free(blob);
+        }
+        if (i == count)
+            err = GIT_ITEROVER;
+    }
+    Py_END_ALLOW_THREADS
+
+    git_note_iterator_free(iter);
+
+    if (oom) {
+        note_records_free(records, count);
+        PyErr_SetNone(PyExc_MemoryError);
+        return NULL;
+    }
+
+    if (err < 0 && err != GIT_ITEROVER) {
+        note_records_free(records, count);
+        return Error_set(err);
+    }
+
+    py_result = PyList_New(count);
+    if (py_result == NULL) {
+        note_records_free(records, count);
+        return NULL;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (records[i].message != NULL) {
+            py_message = to_unicode(records[i].message, NULL, NULL);
+            if (py_message == NULL)
+                goto error;
+        } else {
+            py_message = Py_None;
+            Py_INCREF(py_message);
+        }
+
+        py_record = Py_BuildValue("(NNN)",
+                                  git_oid_to_python(&records[i].annotated_id),
+                                  git_oid_to_python(&records[i].note_id),
+                                  py_message);
+        if (py_record == NULL)
+            goto error;
+
+        PyList_SET_ITEM(py_result, i, py_record);
+    }
+
+    note_records_free(records, count);
+    return py_result;
+
+error:
+    note_records_free(records, count);
+    Py_DECREF(py_result);
+    return NULL;
+}
+
+
 PyDoc_STRVAR(Repository_create_note__doc__,
   "create_note(message, author, committer, annotated_id [,ref, force]) -> Oid\n"
   "\n"
@@ -1397,6 +2841,7 @@ Repository_create_note(Repository *self, PyObject* args)
     if (err < 0)
         return Error_set(err);
 
+    Repository_invalidate_ref_caches(self);
     return git_oid_to_python(&note_id);
 }
 
@@ -1425,32 +2870,47 @@ Repository_lookup_note(Repository *self, PyObject* args)
 
 PyMethodDef Repository_methods[] = {
     METHOD(Repository, create_blob, METH_VARARGS),
+    METHOD(Repository, create_blobs, METH_O),
+    METHOD(Repository, create_blob_fromstream, METH_VARARGS),
     METHOD(Repository, create_blob_fromworkdir, METH_VARARGS),
     METHOD(Repository, create_blob_fromdisk, METH_VARARGS),
+    METHOD(Repository, create_blobs_fromdisk, METH_O),
     METHOD(Repository, create_commit, METH_VARARGS),
     METHOD(Repository, create_tag, METH_VARARGS),
     METHOD(Repository, TreeBuilder, METH_VARARGS),
+    METHOD(Repository, PackBuilder, METH_NOARGS),
     METHOD(Repository, walk, METH_VARARGS),
     METHOD(Repository, merge_base, METH_VARARGS),
+    METHOD(Repository, merge_base_many, METH_O),
+    METHOD(Repository, ahead_behind, METH_VARARGS),
     METHOD(Repository, read, METH_O),
+    METHOD(Repository, read_multi, METH_VARARGS | METH_KEYWORDS),
     METHOD(Repository, write, METH_VARARGS),
     METHOD(Repository, create_reference_direct, METH_VARARGS),
     METHOD(Repository, create_reference_symbolic, METH_VARARGS),
     METHOD(Repository, listall_references, METH_NOARGS),
+    METHOD(Repository, iter_references, METH_NOARGS),
     METHOD(Repository, lookup_reference, METH_O),
+    METHOD(Repository, invalidate_refs, METH_NOARGS),
     METHOD(Repository, revparse_single, METH_O),
-    METHOD(Repository, status, METH_NOARGS),
+    METHOD(Repository, revparse_many, METH_O),
+    METHOD(Repository, peel, METH_VARARGS),
+    METHOD(Repository, status, METH_VARARGS | METH_KEYWORDS),
     METHOD(Repository, status_file, METH_O),
+    METHOD(Repository, status_files, METH_O),
+    METHOD(Repository, is_dirty, METH_VARARGS | METH_KEYWORDS),
     METHOD(Repository, create_remote, METH_VARARGS),
     METHOD(Repository, checkout_head, METH_VARARGS),
     METHOD(Repository, checkout_index, METH_VARARGS),
     METHOD(Repository, checkout_tree, METH_VARARGS),
     METHOD(Repository, notes, METH_VARARGS),
+    METHOD(Repository, notes_all, METH_VARARGS),
     METHOD(Repository, create_note, METH_VARARGS),
     METHOD(Repository, lookup_note, METH_VARARGS),
     METHOD(Repository, git_object_lookup_prefix, METH_O),
     METHOD(Repository, lookup_branch, METH_VARARGS),
     METHOD(Repository, listall_branches, METH_VARARGS),
+    METHOD(Repository, iter_branches, METH_VARARGS),
     METHOD(Repository, create_branch, METH_VARARGS),
     {NULL}
 };
@@ -1466,6 +2926,8 @@ PyGetSetDef Repository_getseters[] = {
     GETTER(Repository, config),
     GETTER(Repository, workdir),
     GETTER(Repository, remotes),
+    GETSET(Repository, object_cache_size),
+    GETSET(Repository, revparse_cache_size),
     {NULL}
 };
 
@@ -40,10 +40,14 @@ int  Repository_contains(Repository *self, PyObject *value);
 
 git_odb_object*
 Repository_read_raw(git_repository *repo, const git_oid *oid, size_t len);
+PyObject* Repository_cache_get(Repository *self, const git_oid *oid);
+void Repository_cache_put(Repository *self, Object *py_obj);
 
 PyObject* Repository_head(Repository *self);
 PyObject* Repository_getitem(Repository *self, PyObject *value);
 PyObject* Repository_read(Repository *self, PyObject *py_hex);
+PyObject* Repository_read_multi(Repository *self, PyObject *args,
+                                PyObject *kwds);
 PyObject* Repository_write(Repository *self, PyObject *args);
 PyObject* Repository_get_index(Repository *self, void *closure);
 PyObject* Repository_get_path(Repository *self, void *closure);
@@ -51,11 +55,17 @@ PyObject* Repository_get_workdir(Repository *self, void *closure);
 PyObject* Repository_get_config(Repository *self, void *closure);
 PyObject* Repository_walk(Repository *self, PyObject *args);
 PyObject* Repository_create_blob(Repository *self, PyObject *args);
+PyObject* Repository_create_blobs(Repository *self, PyObject *py_buffers);
+PyObject* Repository_create_blobs_fromdisk(Repository *self,
+                                           PyObject *py_paths);
 PyObject* Repository_create_blob_fromfile(Repository *self, PyObject *args);
 PyObject* Repository_create_commit(Repository *self, PyObject *args);
 PyObject* Repository_create_tag(Repository *self, PyObject *args);
 PyObject* Repository_create_branch(Repository *self, PyObject *args);
 PyObject* Repository_listall_references(Repository *self, PyObject *args);
+PyObject* Repository_iter_references(Repository *self);
+void Repository_invalidate_ref_caches(Repository *self);
+PyObject* Repository_invalidate_refs(Repository *self);
 PyObject* Repository_listall_branches(Repository *self, PyObject *args);
 PyObject* Repository_lookup_reference(Repository *self, PyObject *py_name);
 
@@ -63,7 +73,7 @@ PyObject*
 Repository_create_reference(Repository *self, PyObject *args, PyObject* kw);
 
 PyObject* Repository_packall_references(Repository *self,  PyObject *args);
-PyObject* Repository_status(Repository *self, PyObject *args);
+PyObject* Repository_status(Repository *self, PyObject *args, PyObject *kwds);
 PyObject* Repository_status_file(Repository *self, PyObject *value);
 PyObject* Repository_TreeBuilder(Repository *self, PyObject *args);
 
@@ -33,6 +33,14 @@
 #include "oid.h"
 #include "signature.h"
 
+extern PyTypeObject SignatureType;
+
+/* Commit attribute access churns through Signature objects, keep a
+ * small free list to spare the general allocator. */
+#define SIGNATURE_MAXFREELIST 64
+static Signature *signature_freelist[SIGNATURE_MAXFREELIST];
+static int signature_numfree = 0;
+
 int
 Signature_init(Signature *self, PyObject *args, PyObject *kwds)
 {
@@ -66,6 +74,8 @@ Signature_init(Signature *self, PyObject *args, PyObject *kwds)
 
     self->obj = NULL;
     self->signature = signature;
+    self->py_name = NULL;
+    self->py_email = NULL;
 
     if (encoding) {
         self->encoding = strdup(encoding);
@@ -81,6 +91,9 @@ Signature_init(Signature *self, PyObject *args, PyObject *kwds)
 void
 Signature_dealloc(Signature *self)
 {
+    Py_CLEAR(self->py_name);
+    Py_CLEAR(self->py_email);
+
     if (self->obj)
         Py_CLEAR(self->obj);
     else {
@@ -88,7 +101,11 @@ Signature_dealloc(Signature *self)
         free((char*)self->encoding);
     }
 
-    PyObject_Del(self);
+    if (Py_TYPE(self) == &SignatureType &&
+        signature_numfree < SIGNATURE_MAXFREELIST)
+        signature_freelist[signature_numfree++] = self;
+    else
+        PyObject_Del(self);
 }
 
 
@@ -130,7 +147,14 @@ PyDoc_STRVAR(Signature_name__doc__, "Name.");
 PyObject *
 Signature_name__get__(Signature *self)
 {
-    return to_unicode(self->signature->name, self->encoding, "strict");
+    /* Decode on first access only, jobs which stick to the raw_*
+     * attributes never pay for the unicode conversion. */
+    if (self->py_name == NULL)
+        self->py_name = to_unicode(self->signature->name, self->encoding,
+                                   "strict");
+
+    Py_XINCREF(self->py_name);
+    return self->py_name;
 }
 
 
@@ -139,7 +163,12 @@ PyDoc_STRVAR(Signature_email__doc__, "Email address.");
 PyObject *
 Signature_email__get__(Signature *self)
 {
-    return to_unicode(self->signature->email, self->encoding, "strict");
+    if (self->py_email == NULL)
+        self->py_email = to_unicode(self->signature->email, self->encoding,
+                                    "strict");
+
+    Py_XINCREF(self->py_email);
+    return self->py_email;
 }
 
 
@@ -221,13 +250,19 @@ build_signature(Object *obj, const git_signature *signature,
 {
     Signature *py_signature;
 
-    py_signature = PyObject_New(Signature, &SignatureType);
+    if (signature_numfree > 0) {
+        py_signature = signature_freelist[--signature_numfree];
+        (void)PyObject_INIT(py_signature, &SignatureType);
+    } else
+        py_signature = PyObject_New(Signature, &SignatureType);
 
     if (py_signature) {
         Py_INCREF(obj);
         py_signature->obj = obj;
         py_signature->signature = signature;
         py_signature->encoding = encoding;
+        py_signature->py_name = NULL;
+        py_signature->py_email = NULL;
     }
     return (PyObject*)py_signature;
 }
@@ -39,12 +39,23 @@ extern PyTypeObject TreeType;
 extern PyTypeObject DiffType;
 extern PyTypeObject TreeIterType;
 extern PyTypeObject IndexType;
+extern PyTypeObject TreeEntryType;
+
+/* Tree iteration churns through TreeEntry objects, keep a small free
+ * list to spare the general allocator. */
+#define TREE_ENTRY_MAXFREELIST 64
+static TreeEntry *tree_entry_freelist[TREE_ENTRY_MAXFREELIST];
+static int tree_entry_numfree = 0;
 
 void
 TreeEntry_dealloc(TreeEntry *self)
 {
     git_tree_entry_free((git_tree_entry*)self->entry);
-    PyObject_Del(self);
+    if (Py_TYPE(self) == &TreeEntryType &&
+        tree_entry_numfree < TREE_ENTRY_MAXFREELIST)
+        tree_entry_freelist[tree_entry_numfree++] = self;
+    else
+        PyObject_Del(self);
 }
 
 
@@ -62,7 +73,7 @@ PyDoc_STRVAR(TreeEntry_name__doc__, "Name.");
 PyObject *
 TreeEntry_name__get__(TreeEntry *self)
 {
-    return to_path(git_tree_entry_name(self->entry));
+    return to_path_interned(git_tree_entry_name(self->entry));
 }
 
 
@@ -164,7 +175,11 @@ wrap_tree_entry(const git_tree_entry *entry)
 {
     TreeEntry *py_entry;
 
-    py_entry = PyObject_New(TreeEntry, &TreeEntryType);
+    if (tree_entry_numfree > 0) {
+        py_entry = tree_entry_freelist[--tree_entry_numfree];
+        (void)PyObject_INIT(py_entry, &TreeEntryType);
+    } else
+        py_entry = PyObject_New(TreeEntry, &TreeEntryType);
     if (py_entry)
         py_entry->entry = entry;
 
@@ -271,6 +286,77 @@ Tree_getitem(Tree *self, PyObject *value)
 }
 
 
+static int
+tree_walk_preorder_cb(const char *root, const git_tree_entry *entry,
+                      void *payload)
+{
+    PyObject *accum = (PyObject*)payload;
+    PyObject *py_path, *py_tuple;
+    const char *name;
+    size_t root_len, name_len;
+    char *path;
+    int err;
+
+    /* The entry is borrowed and the path built in place, nothing is
+     * duplicated besides the tuple handed out. */
+    name = git_tree_entry_name(entry);
+    root_len = strlen(root);
+    name_len = strlen(name);
+    path = malloc(root_len + name_len + 1);
+    if (path == NULL) {
+        PyErr_SetNone(PyExc_MemoryError);
+        return -1;
+    }
+    memcpy(path, root, root_len);
+    memcpy(path + root_len, name, name_len + 1);
+
+    py_path = to_path(path);
+    free(path);
+    if (py_path == NULL)
+        return -1;
+
+    py_tuple = Py_BuildValue("(NNl)", py_path,
+                             git_oid_to_python(git_tree_entry_id(entry)),
+                             (long)git_tree_entry_filemode(entry));
+    if (py_tuple == NULL)
+        return -1;
+
+    err = PyList_Append(accum, py_tuple);
+    Py_DECREF(py_tuple);
+    return (err < 0) ? -1 : 0;
+}
+
+PyDoc_STRVAR(Tree_walk_preorder__doc__,
+  "walk_preorder() -> [(path, Oid, filemode), ...]\n"
+  "\n"
+  "Walk the tree and all its subtrees in pre-order, in a single pass at\n"
+  "the C level, without materializing a Tree wrapper per directory.\n"
+  "Returns a list with a (path, Oid, filemode) tuple for every entry\n"
+  "found, subtrees included, with paths relative to this tree.");
+
+PyObject *
+Tree_walk_preorder(Tree *self)
+{
+    PyObject *accum;
+    int err;
+
+    accum = PyList_New(0);
+    if (accum == NULL)
+        return NULL;
+
+    err = git_tree_walk(self->tree, GIT_TREEWALK_PRE, tree_walk_preorder_cb,
+                        accum);
+    if (err < 0) {
+        Py_DECREF(accum);
+        if (err == GIT_EUSER)
+            return NULL;
+        return Error_set(err);
+    }
+
+    return accum;
+}
+
+
 PyDoc_STRVAR(Tree_diff_to_workdir__doc__,
   "diff_to_workdir([flags, context_lines, interhunk_lines]) -> Diff\n"
   "\n"
@@ -299,7 +385,9 @@ Tree_diff_to_workdir(Tree *self, PyObject *args)
         return NULL;
 
     py_repo = self->repo;
+    Py_BEGIN_ALLOW_THREADS
     err = git_diff_tree_to_workdir(&diff, py_repo->repo, self->tree, &opts);
+    Py_END_ALLOW_THREADS
     if (err < 0)
         return Error_set(err);
 
@@ -340,8 +428,10 @@ Tree_diff_to_index(Tree *self, PyObject *args, PyObject *kwds)
         return NULL;
 
     py_repo = self->repo;
+    Py_BEGIN_ALLOW_THREADS
     err = git_diff_tree_to_index(&diff, py_repo->repo, self->tree,
                                  py_idx->index, &opts);
+    Py_END_ALLOW_THREADS
     if (err < 0)
         return Error_set(err);
 
@@ -397,7 +487,9 @@ Tree_diff_to_tree(Tree *self, PyObject *args, PyObject *kwds)
         to = tmp;
     }
 
+    Py_BEGIN_ALLOW_THREADS
     err = git_diff_tree_to_tree(&diff, py_repo->repo, from, to, &opts);
+    Py_END_ALLOW_THREADS
     if (err < 0)
         return Error_set(err);
 
@@ -423,6 +515,7 @@ PyMappingMethods Tree_as_mapping = {
 };
 
 PyMethodDef Tree_methods[] = {
+    METHOD(Tree, walk_preorder, METH_NOARGS),
     METHOD(Tree, diff_to_tree, METH_VARARGS | METH_KEYWORDS),
     METHOD(Tree, diff_to_workdir, METH_VARARGS),
     METHOD(Tree, diff_to_index, METH_VARARGS | METH_KEYWORDS),
@@ -77,10 +77,91 @@ TreeBuilder_insert(TreeBuilder *self, PyObject *args)
 }
 
 
+PyDoc_STRVAR(TreeBuilder_insert_many__doc__,
+    "insert_many(entries)\n"
+    "\n"
+    "Insert or replace a batch of entries in one C loop. Every entry is\n"
+    "a (name, oid, attr) tuple like the insert() arguments. This avoids\n"
+    "the per-entry Python call overhead when building big trees.");
+
+PyObject *
+TreeBuilder_insert_many(TreeBuilder *self, PyObject *py_entries)
+{
+    PyObject *py_items, *py_oid;
+    const char **fnames = NULL;
+    git_oid *oids = NULL;
+    int *attrs = NULL;
+    Py_ssize_t n, i;
+    size_t len;
+    int err = 0;
+
+    /* Parse everything first, so the inserts can run in a single loop
+     * without the GIL. The list keeps the name buffers alive. */
+    py_items = PySequence_Fast(py_entries,
+                               "entries must be an iterable of tuples");
+    if (py_items == NULL)
+        return NULL;
+
+    n = PySequence_Fast_GET_SIZE(py_items);
+    if (n == 0) {
+        Py_DECREF(py_items);
+        Py_RETURN_NONE;
+    }
+
+    fnames = malloc(n * sizeof(char*));
+    oids = malloc(n * sizeof(git_oid));
+    attrs = malloc(n * sizeof(int));
+    if (fnames == NULL || oids == NULL || attrs == NULL) {
+        PyErr_SetNone(PyExc_MemoryError);
+        goto out;
+    }
+
+    for (i = 0; i < n; i++) {
+        PyObject *py_entry = PySequence_Fast_GET_ITEM(py_items, i);
+
+        if (!PyTuple_Check(py_entry)) {
+            PyErr_SetString(PyExc_TypeError,
+                            "every entry must be a (name, oid, attr) tuple");
+            goto out;
+        }
+
+        if (!PyArg_ParseTuple(py_entry, "sOi", &fnames[i], &py_oid,
+                              &attrs[i]))
+            goto out;
+
+        len = py_oid_to_git_oid(py_oid, &oids[i]);
+        if (len == 0)
+            goto out;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < n; i++) {
+        err = git_treebuilder_insert(NULL, self->bld, fnames[i], &oids[i],
+                                     attrs[i]);
+        if (err < 0)
+            break;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (err < 0)
+        Error_set(err);
+
+out:
+    free(attrs);
+    free(oids);
+    free(fnames);
+    Py_DECREF(py_items);
+    if (err < 0 || PyErr_Occurred())
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+
 PyDoc_STRVAR(TreeBuilder_write__doc__,
     "write() -> Oid\n"
     "\n"
-    "Write the tree to the given repository.");
+    "Write the tree to the given repository. The GIL is released while\n"
+    "the tree is sorted and serialized into the object database.");
 
 PyObject *
 TreeBuilder_write(TreeBuilder *self)
@@ -88,7 +169,9 @@ TreeBuilder_write(TreeBuilder *self)
     int err;
     git_oid oid;
 
+    Py_BEGIN_ALLOW_THREADS
     err = git_treebuilder_write(&oid, self->repo->repo, self->bld);
+    Py_END_ALLOW_THREADS
     if (err < 0)
         return Error_set(err);
 
@@ -164,6 +247,7 @@ PyMethodDef TreeBuilder_methods[] = {
     METHOD(TreeBuilder, clear, METH_NOARGS),
     METHOD(TreeBuilder, get, METH_O),
     METHOD(TreeBuilder, insert, METH_VARARGS),
+    METHOD(TreeBuilder, insert_many, METH_O),
     METHOD(TreeBuilder, remove, METH_O),
     METHOD(TreeBuilder, write, METH_NOARGS),
     {NULL}
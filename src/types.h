@@ -43,6 +43,11 @@ typedef struct {
     git_repository *repo;
     PyObject *index;  /* It will be None for a bare repository */
     PyObject *config; /* It will be None for a bare repository */
+    PyObject *object_cache;       /* Oid -> Object, NULL when disabled */
+    Py_ssize_t object_cache_size; /* Maximum entries, 0 disables caching */
+    PyObject *head_cache;         /* Resolved HEAD, see invalidate_refs() */
+    PyObject *revparse_cache;         /* spec -> Oid, NULL when disabled */
+    Py_ssize_t revparse_cache_size;   /* Maximum entries, 0 disables caching */
 } Repository;
 
 
@@ -83,7 +88,7 @@ typedef struct {
     PyObject_HEAD
     Repository *repo;
     git_note *note;
-    char* annotated_id;
+    git_oid annotated_id;  /* Formatted to hex only on access */
 } Note;
 
 typedef struct {
@@ -104,20 +109,28 @@ typedef struct {
     size_t n;
 } DiffIter;
 
+/* Iterates over the same diff, but yields delta records instead of
+ * building patches. */
+typedef DiffIter DeltaIter;
+
 typedef struct {
     PyObject_HEAD
-    PyObject* hunks;
+    Diff* diff;
+    git_diff_patch* patch;
+    PyObject* hunks;  /* Lazily built, see Patch_hunks__get__ */
     const char * old_file_path;
     const char * new_file_path;
-    char* old_oid;
-    char* new_oid;
+    git_oid old_oid;  /* Formatted to hex only on access */
+    git_oid new_oid;
     char status;
     unsigned similarity;
 } Patch;
 
 typedef struct {
     PyObject_HEAD
-    PyObject* lines;
+    Patch* patch;
+    size_t idx;
+    PyObject* lines;  /* Lazily built, see Hunk_lines__get__ */
     int old_start;
     int old_lines;
     int new_start;
@@ -155,6 +168,10 @@ typedef struct {
 } IndexIter;
 
 
+/* git_packbuilder */
+SIMPLE_TYPE(PackBuilder, git_packbuilder, pb)
+
+
 /* git_reference, git_reflog */
 SIMPLE_TYPE(Walker, git_revwalk, walk)
 
@@ -165,8 +182,8 @@ typedef Reference Branch;
 typedef struct {
     PyObject_HEAD
     git_signature *signature;
-    char *oid_old;
-    char *oid_new;
+    git_oid oid_old;  /* Formatted to hex only on access */
+    git_oid oid_new;
     char *message;
 } RefLogEntry;
 
@@ -177,6 +194,26 @@ typedef struct {
     size_t size;
 } RefLogIter;
 
+/* Iterates over a snapshot of the reference names, converting them to
+ * Python strings one at a time. */
+typedef struct {
+    PyObject_HEAD
+    git_strarray array;
+    size_t i;
+} RefsIter;
+
+/* Iterates over a snapshot of the branch names, resolving each branch
+ * to a lightweight (name, target, is_head) record only when it is
+ * yielded. */
+typedef struct {
+    PyObject_HEAD
+    Repository *repo;
+    char **names;
+    git_branch_t *types;
+    size_t i;
+    size_t count;
+} BranchesIter;
+
 
 /* git_signature */
 typedef struct {
@@ -184,6 +221,8 @@ typedef struct {
     Object *obj;
     const git_signature *signature;
     const char *encoding;
+    PyObject *py_name;   /* Decoded lazily, see Signature_name__get__ */
+    PyObject *py_email;
 } Signature;
 
 
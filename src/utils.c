@@ -60,3 +60,56 @@ py_str_to_c_str(PyObject *value, const char *encoding)
                  Py_TYPE(value)->tp_name);
     return NULL;
 }
+
+
+/* Path object cache, shared by the tree and index entry wrappers. The
+ * same file names repeat across thousands of trees in a walk, hand
+ * back the one already decoded object instead of building a new one
+ * per access. Keyed by the raw name bytes, so a hit costs a hash
+ * lookup and no decoding. */
+#define PATH_CACHE_MAXSIZE 32768
+static PyObject *path_cache;  /* bytes -> path object */
+
+PyObject *
+to_path_interned(const char *path)
+{
+    PyObject *py_key, *py_path;
+
+    if (path_cache == NULL) {
+        path_cache = PyDict_New();
+        if (path_cache == NULL) {
+            PyErr_Clear();
+            return to_path(path);
+        }
+    }
+
+    py_key = PyBytes_FromString(path);
+    if (py_key == NULL) {
+        PyErr_Clear();
+        return to_path(path);
+    }
+
+    py_path = PyDict_GetItem(path_cache, py_key);
+    if (py_path != NULL) {
+        Py_DECREF(py_key);
+        Py_INCREF(py_path);
+        return py_path;
+    }
+
+    py_path = to_path(path);
+    if (py_path == NULL) {
+        Py_DECREF(py_key);
+        return NULL;
+    }
+
+    /* Poor man's eviction: throw everything away when full */
+    if (PyDict_Size(path_cache) >= PATH_CACHE_MAXSIZE)
+        PyDict_Clear(path_cache);
+
+    /* Caching is best effort */
+    if (PyDict_SetItem(path_cache, py_key, py_path) < 0)
+        PyErr_Clear();
+
+    Py_DECREF(py_key);
+    return py_path;
+}
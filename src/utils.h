@@ -109,6 +109,10 @@ to_bytes(const char * value)
 
 char * py_str_to_c_str(PyObject *value, const char *encoding);
 
+/* Like to_path, but identical names share the same cached object. Use
+ * it for names that repeat a lot (tree and index entries). */
+PyObject * to_path_interned(const char *path);
+
 #define py_path_to_c_str(py_path) \
         py_str_to_c_str(py_path, Py_FileSystemDefaultEncoding)
 
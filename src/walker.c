@@ -32,6 +32,7 @@
 #include "oid.h"
 #include "tree.h"
 #include "walker.h"
+#include "instrumentation.h"
 
 extern PyTypeObject CommitType;
 
@@ -90,6 +91,114 @@ Walker_push(Walker *self, PyObject *py_hex)
 }
 
 
+PyDoc_STRVAR(Walker_push_many__doc__,
+  "push_many(oids)\n"
+  "\n"
+  "Mark a list of commits to start traversal from. Equivalent to\n"
+  "calling push() once per oid, without the per-call overhead.");
+
+PyObject *
+Walker_push_many(Walker *self, PyObject *py_oids)
+{
+    Py_ssize_t len, i;
+    int err;
+    git_oid oid;
+
+    if (!PyList_Check(py_oids)) {
+        PyErr_SetString(PyExc_TypeError, "oids must be a list");
+        return NULL;
+    }
+
+    len = PyList_GET_SIZE(py_oids);
+    for (i = 0; i < len; i++) {
+        err = py_oid_to_git_oid_expand(self->repo->repo,
+                                       PyList_GET_ITEM(py_oids, i), &oid);
+        if (err < 0)
+            return NULL;
+
+        err = git_revwalk_push(self->walk, &oid);
+        if (err < 0)
+            return Error_set(err);
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+PyDoc_STRVAR(Walker_hide_many__doc__,
+  "hide_many(oids)\n"
+  "\n"
+  "Mark a list of commits (and their ancestors) uninteresting for the\n"
+  "output. Equivalent to calling hide() once per oid, without the\n"
+  "per-call overhead.");
+
+PyObject *
+Walker_hide_many(Walker *self, PyObject *py_oids)
+{
+    Py_ssize_t len, i;
+    int err;
+    git_oid oid;
+
+    if (!PyList_Check(py_oids)) {
+        PyErr_SetString(PyExc_TypeError, "oids must be a list");
+        return NULL;
+    }
+
+    len = PyList_GET_SIZE(py_oids);
+    for (i = 0; i < len; i++) {
+        err = py_oid_to_git_oid_expand(self->repo->repo,
+                                       PyList_GET_ITEM(py_oids, i), &oid);
+        if (err < 0)
+            return NULL;
+
+        err = git_revwalk_hide(self->walk, &oid);
+        if (err < 0)
+            return Error_set(err);
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+PyDoc_STRVAR(Walker_skip__doc__,
+  "skip(n) -> int\n"
+  "\n"
+  "Advance the walk n commits without materializing them, and return\n"
+  "the number actually skipped (less than n when the walk ends early).\n"
+  "Together with next_batch() this makes pagination cheap: skip the\n"
+  "offset at the C level, then fetch one page.");
+
+PyObject *
+Walker_skip(Walker *self, PyObject *args)
+{
+    git_oid oid;
+    Py_ssize_t n, count = 0;
+    int err = 0;
+
+    if (!PyArg_ParseTuple(args, "n", &n))
+        return NULL;
+
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "n must not be negative");
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    while (count < n) {
+        err = git_revwalk_next(&oid, self->walk);
+        if (err < 0)
+            break;
+        count++;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (err < 0 && err != GIT_ITEROVER)
+        return Error_set(err);
+
+    return PyLong_FromSsize_t(count);
+}
+
+
 PyDoc_STRVAR(Walker_sort__doc__,
   "sort(mode)\n"
   "\n"
@@ -122,6 +231,224 @@ Walker_reset(Walker *self)
     Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR(Walker_next_batch__doc__,
+  "next_batch(n) -> [Commit, ...]\n"
+  "\n"
+  "Return a list with the next n commits of the walk. The list is shorter\n"
+  "than n (eventually empty) when the walk is over. Compared with plain\n"
+  "iteration this amortizes the per-commit call overhead, which matters\n"
+  "when traversing very big histories.");
+
+PyObject *
+Walker_next_batch(Walker *self, PyObject *args)
+{
+    git_oid *oids;
+    git_commit *commit;
+    Commit *py_commit;
+    PyObject *py_result;
+    Py_ssize_t n, i, count = 0;
+    int err = 0;
+
+    if (!PyArg_ParseTuple(args, "n", &n))
+        return NULL;
+
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "n must not be negative");
+        return NULL;
+    }
+
+    if (n == 0)
+        return PyList_New(0);
+
+    oids = malloc(n * sizeof(git_oid));
+    if (oids == NULL) {
+        PyErr_SetNone(PyExc_MemoryError);
+        return NULL;
+    }
+
+    /* Drain the revwalk in one go, without a Python round trip (or the
+     * GIL) per commit. */
+    Py_BEGIN_ALLOW_THREADS
+    while (count < n) {
+        err = git_revwalk_next(&oids[count], self->walk);
+        if (err < 0)
+            break;
+        count++;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (err < 0 && err != GIT_ITEROVER) {
+        free(oids);
+        return Error_set(err);
+    }
+
+    py_result = PyList_New(count);
+    if (py_result == NULL) {
+        free(oids);
+        return NULL;
+    }
+
+    for (i = 0; i < count; i++) {
+        err = git_commit_lookup(&commit, self->repo->repo, &oids[i]);
+        if (err < 0) {
+            free(oids);
+            Py_DECREF(py_result);
+            return Error_set(err);
+        }
+
+        py_commit = PyObject_GC_New(Commit, &CommitType);
+        if (py_commit == NULL) {
+            git_commit_free(commit);
+            free(oids);
+            Py_DECREF(py_result);
+            return NULL;
+        }
+        py_commit->commit = commit;
+        Py_INCREF(self->repo);
+        py_commit->repo = self->repo;
+        PyObject_GC_Track(py_commit);
+        PyList_SET_ITEM(py_result, i, (PyObject*)py_commit);
+    }
+
+    free(oids);
+    return py_result;
+}
+
+/* A metadata record stashed while the GIL is released, see
+ * Walker_records. */
+typedef struct {
+    git_oid oid;
+    char *name;
+    char *email;
+    char *encoding;
+    long long time;
+    unsigned int parents;
+} walk_record;
+
+static void
+walk_records_free(walk_record *records, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        free(records[i].name);
+        free(records[i].email);
+        free(records[i].encoding);
+    }
+    free(records);
+}
+
+PyDoc_STRVAR(Walker_records__doc__,
+  "records() -> [(oid, author_name, author_email, commit_time,\n"
+  "               parent_count), ...]\n"
+  "\n"
+  "Drain the walk and return one metadata tuple per commit, extracted at\n"
+  "the C level. No Commit wrappers are created, which makes this much\n"
+  "cheaper than iteration when only the commit metadata is needed.");
+
+PyObject *
+Walker_records(Walker *self)
+{
+    walk_record *records = NULL, *tmp;
+    git_commit *commit;
+    const git_signature *author;
+    const char *encoding;
+    size_t count = 0, size = 0, i;
+    PyObject *py_result, *py_record, *py_name, *py_email;
+    int err = 0;
+    int oom = 0;
+
+    Py_BEGIN_ALLOW_THREADS
+    for (;;) {
+        git_oid oid;
+
+        err = git_revwalk_next(&oid, self->walk);
+        if (err < 0)
+            break;
+
+        err = git_commit_lookup(&commit, self->repo->repo, &oid);
+        if (err < 0)
+            break;
+
+        if (count >= size) {
+            size = size ? size * 2 : 64;
+            tmp = realloc(records, size * sizeof(walk_record));
+            if (tmp == NULL) {
+                git_commit_free(commit);
+                oom = 1;
+                break;
+            }
+            records = tmp;
+        }
+
+        author = git_commit_author(commit);
+        encoding = git_commit_message_encoding(commit);
+
+        git_oid_cpy(&records[count].oid, &oid);
+        records[count].name = strdup(author->name);
+        records[count].email = strdup(author->email);
+        records[count].encoding = encoding ? strdup(encoding) : NULL;
+        records[count].time = git_commit_time(commit);
+        records[count].parents = git_commit_parentcount(commit);
+        git_commit_free(commit);
+
+        if (records[count].name == NULL || records[count].email == NULL) {
+            count++;
+            oom = 1;
+            break;
+        }
+        count++;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (oom) {
+        walk_records_free(records, count);
+        PyErr_SetNone(PyExc_MemoryError);
+        return NULL;
+    }
+
+    if (err < 0 && err != GIT_ITEROVER) {
+        walk_records_free(records, count);
+        return Error_set(err);
+    }
+
+    py_result = PyList_New(count);
+    if (py_result == NULL) {
+        walk_records_free(records, count);
+        return NULL;
+    }
+
+    for (i = 0; i < count; i++) {
+        py_name = to_unicode(records[i].name, records[i].encoding, "strict");
+        if (py_name == NULL)
+            goto error;
+
+        py_email = to_unicode(records[i].email, records[i].encoding,
+                              "strict");
+        if (py_email == NULL) {
+            Py_DECREF(py_name);
+            goto error;
+        }
+
+        py_record = Py_BuildValue("(NNNLI)",
+                                  git_oid_to_python(&records[i].oid),
+                                  py_name, py_email, records[i].time,
+                                  records[i].parents);
+        if (py_record == NULL)
+            goto error;
+
+        PyList_SET_ITEM(py_result, i, py_record);
+    }
+
+    walk_records_free(records, count);
+    return py_result;
+
+error:
+    walk_records_free(records, count);
+    Py_DECREF(py_result);
+    return NULL;
+}
+
 PyObject *
 Walker_iter(Walker *self)
 {
@@ -136,6 +463,7 @@ Walker_iternext(Walker *self)
     git_commit *commit;
     Commit *py_commit;
     git_oid oid;
+    STATS_START(t);
 
     err = git_revwalk_next(&oid, self->walk);
     if (err < 0)
@@ -145,19 +473,26 @@ Walker_iternext(Walker *self)
     if (err < 0)
         return Error_set(err);
 
-    py_commit = PyObject_New(Commit, &CommitType);
+    py_commit = PyObject_GC_New(Commit, &CommitType);
     if (py_commit) {
         py_commit->commit = commit;
         Py_INCREF(self->repo);
         py_commit->repo = self->repo;
+        PyObject_GC_Track(py_commit);
     }
+    STATS_END(STATS_WALKER_ITERNEXT, t);
     return (PyObject*)py_commit;
 }
 
 PyMethodDef Walker_methods[] = {
     METHOD(Walker, hide, METH_O),
+    METHOD(Walker, hide_many, METH_O),
+    METHOD(Walker, next_batch, METH_VARARGS),
     METHOD(Walker, push, METH_O),
+    METHOD(Walker, push_many, METH_O),
+    METHOD(Walker, records, METH_NOARGS),
     METHOD(Walker, reset, METH_NOARGS),
+    METHOD(Walker, skip, METH_VARARGS),
     METHOD(Walker, sort, METH_O),
     {NULL}
 };
@@ -35,7 +35,11 @@
 
 void Walker_dealloc(Walker *self);
 PyObject* Walker_hide(Walker *self, PyObject *py_hex);
+PyObject* Walker_hide_many(Walker *self, PyObject *py_oids);
 PyObject* Walker_push(Walker *self, PyObject *py_hex);
+PyObject* Walker_push_many(Walker *self, PyObject *py_oids);
+PyObject* Walker_next_batch(Walker *self, PyObject *args);
+PyObject* Walker_skip(Walker *self, PyObject *args);
 PyObject* Walker_sort(Walker *self, PyObject *py_sort_mode);
 PyObject* Walker_reset(Walker *self);
 PyObject* Walker_iter(Walker *self);
@@ -30,6 +30,7 @@
 from __future__ import absolute_import
 from __future__ import unicode_literals
 from os.path import dirname, join
+import io
 import unittest
 
 import pygit2
@@ -58,6 +59,12 @@ class BlobTest(utils.RepoTestCase):
         self.assertEqual(len(BLOB_CONTENT), blob.size)
         self.assertEqual(BLOB_CONTENT, blob.read_raw())
 
+    def test_blob_buffer(self):
+        blob = self.repo[BLOB_SHA]
+        view = memoryview(blob)
+        self.assertEqual(len(BLOB_CONTENT), len(view))
+        self.assertEqual(BLOB_CONTENT, view.tobytes())
+
     def test_create_blob(self):
         blob_oid = self.repo.create_blob(BLOB_NEW_CONTENT)
         blob = self.repo[blob_oid]
@@ -74,6 +81,37 @@ class BlobTest(utils.RepoTestCase):
         self.assertEqual(len(BLOB_NEW_CONTENT), blob.size)
         self.assertEqual(BLOB_NEW_CONTENT, blob.read_raw())
 
+    def test_create_blobs(self):
+        self.assertEqual([], self.repo.create_blobs([]))
+        self.assertRaises(TypeError, self.repo.create_blobs, [42])
+
+        contents = [BLOB_NEW_CONTENT, BLOB_FILE_CONTENT]
+        oids = self.repo.create_blobs(contents)
+        self.assertEqual(len(contents), len(oids))
+        for content, blob_oid in zip(contents, oids):
+            self.assertEqual(self.repo.create_blob(content), blob_oid)
+            self.assertEqual(content, self.repo[blob_oid].data)
+
+    def test_create_blob_fromstream(self):
+        blob_oid = self.repo.create_blob_fromstream(
+            io.BytesIO(BLOB_NEW_CONTENT))
+        self.assertEqual(self.repo.create_blob(BLOB_NEW_CONTENT), blob_oid)
+        self.assertEqual(BLOB_NEW_CONTENT, self.repo[blob_oid].data)
+
+        # A tiny chunk size forces several callback round trips
+        blob_oid = self.repo.create_blob_fromstream(
+            io.BytesIO(BLOB_NEW_CONTENT), 2)
+        self.assertEqual(BLOB_NEW_CONTENT, self.repo[blob_oid].data)
+
+        self.assertRaises(ValueError, self.repo.create_blob_fromstream,
+                          io.BytesIO(BLOB_NEW_CONTENT), 0)
+        self.assertRaises(AttributeError,
+                          self.repo.create_blob_fromstream, 42)
+
+    def test_create_blobs_fromdisk(self):
+        oids = self.repo.create_blobs_fromdisk([__file__])
+        self.assertEqual([self.repo.create_blob_fromdisk(__file__)], oids)
+
     def test_create_blob_fromworkdir(self):
 
         blob_oid = self.repo.create_blob_fromworkdir("bye.txt")
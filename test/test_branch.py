@@ -53,6 +53,15 @@ class BranchesTestCase(utils.RepoTestCase):
         branches = sorted(self.repo.listall_branches())
         self.assertEqual(branches, ['i18n', 'master'])
 
+    def test_iter_branches(self):
+        records = sorted(self.repo.iter_branches())
+        self.assertEqual([name for name, target, is_head in records],
+                         ['i18n', 'master'])
+        self.assertEqual([target.hex for name, target, is_head in records],
+                         [I18N_LAST_COMMIT, LAST_COMMIT])
+        self.assertEqual([is_head for name, target, is_head in records],
+                         [False, True])
+
     def test_create_branch(self):
         commit = self.repo[LAST_COMMIT]
         reference = self.repo.create_branch('version1', commit)
@@ -75,6 +84,13 @@ class BranchesTestCase(utils.RepoTestCase):
 
         self.assertTrue(self.repo.lookup_branch('i18n') is None)
 
+    def test_delete_drops_revparse_cache(self):
+        self.repo.revparse_cache_size = 8
+        self.repo.revparse_single('i18n')
+        self.repo.lookup_branch('i18n').delete()
+
+        self.assertRaises(KeyError, self.repo.revparse_single, 'i18n')
+
     def test_cant_delete_master(self):
         branch = self.repo.lookup_branch('master')
 
@@ -140,6 +156,12 @@ class BranchesEmptyRepoTestCase(utils.EmptyRepoTestCase):
         branches = sorted(self.repo.listall_branches(pygit2.GIT_BRANCH_REMOTE))
         self.assertEqual(branches, ['origin/master'])
 
+    def test_iter_branches_remote(self):
+        records = list(self.repo.iter_branches(pygit2.GIT_BRANCH_REMOTE))
+        self.assertEqual([('origin/master', ORIGIN_MASTER_COMMIT, False)],
+                         [(name, target.hex, is_head)
+                          for name, target, is_head in records])
+
     def test_branch_remote_name(self):
         self.repo.remotes[0].fetch()
         branch = self.repo.lookup_branch('origin/master',
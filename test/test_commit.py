@@ -47,6 +47,10 @@ class CommitTest(utils.BareRepoTestCase):
         self.assertEqual(1, len(parents))
         self.assertEqual('c2792cfa289ae6321ecf2cd5806c2194b0fd070c',
                          parents[0].hex)
+        parent_ids = commit.parent_ids
+        self.assertEqual(1, len(parent_ids))
+        self.assertEqual('c2792cfa289ae6321ecf2cd5806c2194b0fd070c',
+                         parent_ids[0].hex)
         self.assertEqual(None, commit.message_encoding)
         self.assertEqual(('Second test data commit.\n\n'
                           'This commit has some additional text.\n'),
@@ -0,0 +1,95 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright 2010-2013 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+"""Tests for the CommitGraph snapshot."""
+
+from __future__ import absolute_import
+from __future__ import unicode_literals
+import os
+import unittest
+
+from pygit2 import CommitGraph
+from pygit2 import GIT_SORT_TIME, GIT_SORT_TOPOLOGICAL, GIT_SORT_REVERSE
+from . import utils
+
+
+ROOT_SHA = 'acecd5ea2924a4b900e7e149496e1f4b57976e51'
+MERGE_SHA = '2be5719152d4f82c7302b1c0932d8e5f0a4a0e98'
+GRAPH_FILENAME = 'test_commit_graph'
+
+
+class CommitGraphTest(utils.BareRepoTestCase):
+
+    def tearDown(self):
+        super(CommitGraphTest, self).tearDown()
+        try:
+            os.remove(GRAPH_FILENAME)
+        except OSError:
+            pass
+
+    def test_build(self):
+        graph = CommitGraph.build(self.repo, [MERGE_SHA])
+        self.assertEqual(5, len(graph))
+        self.assertTrue(ROOT_SHA in graph)
+        self.assertEqual([], graph.parents(ROOT_SHA))
+        self.assertEqual(1, graph.generation(ROOT_SHA))
+        self.assertEqual(4, graph.generation(MERGE_SHA))
+        self.assertEqual(self.repo[ROOT_SHA].commit_time,
+                         graph.commit_time(ROOT_SHA))
+
+    def test_walk_time(self):
+        graph = CommitGraph.build(self.repo, [MERGE_SHA])
+        expected = [commit.hex
+                    for commit in self.repo.walk(MERGE_SHA, GIT_SORT_TIME)]
+        self.assertEqual(expected, list(graph.walk(MERGE_SHA, GIT_SORT_TIME)))
+        self.assertEqual(
+            list(reversed(expected)),
+            list(graph.walk(MERGE_SHA, GIT_SORT_TIME | GIT_SORT_REVERSE)))
+
+    def test_walk_topological(self):
+        # A topological order is not unique, so check the ordering
+        # constraint instead of comparing against Repository.walk()
+        graph = CommitGraph.build(self.repo, [MERGE_SHA])
+        result = list(graph.walk(MERGE_SHA, GIT_SORT_TOPOLOGICAL))
+        self.assertEqual(5, len(result))
+        position = dict((hex, i) for i, hex in enumerate(result))
+        for hex in result:
+            for parent in graph.parents(hex):
+                self.assertTrue(position[hex] < position[parent])
+
+    def test_save_load(self):
+        graph = CommitGraph.build(self.repo, [MERGE_SHA])
+        graph.save(GRAPH_FILENAME)
+
+        loaded = CommitGraph.load(GRAPH_FILENAME)
+        self.assertEqual(len(graph), len(loaded))
+        self.assertEqual(list(graph.walk(MERGE_SHA, GIT_SORT_TIME)),
+                         list(loaded.walk(MERGE_SHA, GIT_SORT_TIME)))
+
+
+if __name__ == '__main__':
+    unittest.main()
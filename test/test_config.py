@@ -182,6 +182,18 @@ class ConfigTest(utils.RepoTestCase):
         self.assertTrue('core.bare' in lst)
         self.assertTrue(lst['core.bare'])
 
+    def test_to_dict(self):
+        config = self.repo.config
+        d = config.to_dict()
+        self.assertTrue(isinstance(d, dict))
+        self.assertEqual(d['core.bare'], 'false')
+        self.assertEqual(d['core.editor'], 'ed')
+
+        # The dict is a snapshot, later writes are not reflected
+        config['core.dummy'] = 'later'
+        self.assertFalse('core.dummy' in d)
+        del config['core.dummy']
+
 
 if __name__ == '__main__':
     unittest.main()
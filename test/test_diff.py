@@ -36,6 +36,11 @@ from pygit2 import GIT_DIFF_IGNORE_WHITESPACE, GIT_DIFF_IGNORE_WHITESPACE_EOL
 from . import utils
 from itertools import chain
 
+try:
+    from StringIO import StringIO
+except ImportError:
+    from io import StringIO
+
 
 COMMIT_SHA1_1 = '5fe808e8953c12735680c257f56600cb0de44b10'
 COMMIT_SHA1_2 = 'c2792cfa289ae6321ecf2cd5806c2194b0fd070c'
@@ -248,6 +253,18 @@ class DiffTest(utils.BareRepoTestCase):
         self.assertEqual(patch.old_file_path, 'a')
         self.assertEqual(patch.new_file_path, 'a')
 
+    def test_diff_deltas(self):
+        commit_a = self.repo[COMMIT_SHA1_1]
+        commit_b = self.repo[COMMIT_SHA1_2]
+
+        diff = commit_a.tree.diff_to_tree(commit_b.tree)
+        deltas = list(diff.deltas)
+        self.assertEqual(len(deltas), len([patch for patch in diff]))
+        self.assertEqual(
+            [(p.old_file_path, p.new_file_path, p.status, p.similarity)
+             for p in diff],
+            deltas)
+
     def test_diff_patch(self):
         commit_a = self.repo[COMMIT_SHA1_1]
         commit_b = self.repo[COMMIT_SHA1_2]
@@ -255,6 +272,24 @@ class DiffTest(utils.BareRepoTestCase):
         diff = commit_a.tree.diff_to_tree(commit_b.tree)
         self.assertEqual(diff.patch, PATCH)
 
+    def test_write_patch(self):
+        commit_a = self.repo[COMMIT_SHA1_1]
+        commit_b = self.repo[COMMIT_SHA1_2]
+
+        diff = commit_a.tree.diff_to_tree(commit_b.tree)
+        out = StringIO()
+        diff.write_patch(out)
+        self.assertEqual(out.getvalue(), PATCH)
+
+    def test_diff_stats(self):
+        commit_a = self.repo[COMMIT_SHA1_1]
+        commit_b = self.repo[COMMIT_SHA1_2]
+
+        diff = commit_a.tree.diff_to_tree(commit_b.tree)
+        self.assertEqual((2, 1, 2), diff.stats)
+        self.assertEqual({'a': (1, 1), 'c/d': (0, 1)},
+                         diff.stats_by_file())
+
     def test_diff_oids(self):
         commit_a = self.repo[COMMIT_SHA1_1]
         commit_b = self.repo[COMMIT_SHA1_2]
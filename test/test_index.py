@@ -139,6 +139,32 @@ class IndexTest(utils.RepoTestCase):
         index.remove('hello.txt')
         self.assertFalse('hello.txt' in index)
 
+    def test_add_many(self):
+        index = self.repo.index
+        index.add_many(['bye.txt'])
+        self.assertTrue('bye.txt' in index)
+        self.assertEqual(index['bye.txt'].hex,
+                         '0907563af06c7464d62a70cdd135a6ba7d2b41d8')
+
+        self.assertRaises(TypeError, index.add_many, 'bye.txt')
+        self.assertRaises(pygit2.GitError, index.add_many, ['not-exists'])
+
+    def test_add_all(self):
+        index = self.repo.index
+        index.add_all()
+        self.assertTrue('bye.txt' in index)
+
+        index.remove('bye.txt')
+        index.add_all(['*.txt'])
+        self.assertTrue('bye.txt' in index)
+
+    def test_remove_many(self):
+        index = self.repo.index
+        index.remove_many(['hello.txt', '.gitignore'])
+        self.assertFalse('hello.txt' in index)
+        self.assertFalse('.gitignore' in index)
+        self.assertRaises(TypeError, index.remove_many, 'hello.txt')
+
 
 if __name__ == '__main__':
     unittest.main()
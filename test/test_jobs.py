@@ -0,0 +1,59 @@
+# -*- coding: UTF-8 -*-
+#
+# Copyright 2010-2013 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+"""Tests for background jobs."""
+
+from __future__ import absolute_import
+from __future__ import unicode_literals
+import unittest
+
+from pygit2 import submit
+from . import utils
+
+
+class JobsTest(utils.RepoTestCase):
+
+    def test_submit(self):
+        job = submit(self.repo.status)
+        self.assertTrue(job.wait())
+        self.assertTrue(job.done())
+        self.assertEqual(job.result(), self.repo.status())
+
+    def test_exception(self):
+        job = submit(self.repo.revparse_single, 'no-such-revision')
+        job.wait()
+        self.assertRaises(KeyError, job.result)
+
+    def test_many(self):
+        jobs = [submit(self.repo.status) for i in range(10)]
+        expected = self.repo.status()
+        for job in jobs:
+            self.assertEqual(job.result(), expected)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -73,6 +73,24 @@ class NotesTest(utils.BareRepoTestCase):
             entry = (note.oid.hex, note.message, note.annotated_id)
             self.assertEqual(NOTES[i], entry)
 
+    def test_notes_all(self):
+        records = self.repo.notes_all()
+        self.assertEqual(len(NOTES), len(records))
+        for expected, (annotated_id, note_id, message) in zip(NOTES, records):
+            self.assertEqual(expected[0], note_id.hex)
+            self.assertEqual(expected[1], message)
+            self.assertEqual(expected[2], annotated_id.hex)
+
+    def test_notes_all_without_messages(self):
+        records = self.repo.notes_all('refs/notes/commits', False)
+        self.assertEqual(len(NOTES), len(records))
+        for annotated_id, note_id, message in records:
+            self.assertEqual(None, message)
+
+    def test_notes_all_non_existing_ref(self):
+        self.assertRaises(KeyError, self.repo.notes_all,
+                          "refs/notes/bad_ref")
+
     def test_iterate_non_existing_ref(self):
         self.assertRaises(KeyError, self.repo.notes, "refs/notes/bad_ref")
 
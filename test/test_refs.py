@@ -54,10 +54,54 @@ class ReferencesTest(utils.RepoTestCase):
                          ['refs/heads/i18n', 'refs/heads/master',
                           'refs/tags/version1'])
 
+    def test_iter_references(self):
+        repo = self.repo
+        it = repo.iter_references()
+        self.assertEqual(sorted(it),
+                         ['refs/heads/i18n', 'refs/heads/master'])
+
+        # The iterator is a snapshot, references created afterwards do
+        # not show up until a new iterator is taken
+        it = repo.iter_references()
+        repo.create_reference('refs/tags/version1', 'refs/heads/master')
+        self.assertEqual(sorted(it),
+                         ['refs/heads/i18n', 'refs/heads/master'])
+        self.assertEqual(sorted(repo.iter_references()),
+                         ['refs/heads/i18n', 'refs/heads/master',
+                          'refs/tags/version1'])
+
     def test_head(self):
         head = self.repo.head
         self.assertEqual(LAST_COMMIT, self.repo[head.target].hex)
 
+    def test_head_cache(self):
+        repo = self.repo
+
+        # Repeated access returns the cached reference
+        head = repo.head
+        self.assertTrue(head is repo.head)
+
+        # The cache is dropped explicitly ...
+        repo.invalidate_refs()
+        self.assertFalse(head is repo.head)
+
+        # ... and when HEAD is moved through pygit2
+        head = repo.head
+        repo.head = 'refs/heads/i18n'
+        self.assertEqual(repo.head.name, 'refs/heads/i18n')
+        self.assertFalse(head is repo.head)
+
+    def test_head_cache_reference_writes(self):
+        repo = self.repo
+
+        # References written through pygit2 drop the cache on their own
+        head = repo.head
+        commit = repo[head.target]
+        master = repo.lookup_reference('refs/heads/master')
+        master.target = commit.parents[0].oid
+        self.assertFalse(head is repo.head)
+        self.assertEqual(repo.head.target.hex, commit.parents[0].hex)
+
     def test_lookup_reference(self):
         repo = self.repo
 
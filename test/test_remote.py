@@ -123,6 +123,17 @@ class EmptyRepositoryTest(utils.EmptyRepoTestCase):
         self.assertEqual(stats['indexed_objects'], REMOTE_REPO_OBJECTS)
         self.assertEqual(stats['received_objects'], REMOTE_REPO_OBJECTS)
 
+    def test_fetch_progress(self):
+        remote = self.repo.remotes[0]
+        calls = []
+        remote.fetch(progress=lambda *args: calls.append(args))
+        self.assertTrue(len(calls) > 0)
+        received, indexed, bytes_ = calls[-1]
+        self.assertEqual(received, REMOTE_REPO_OBJECTS)
+        self.assertEqual(indexed, REMOTE_REPO_OBJECTS)
+
+        self.assertRaises(TypeError, remote.fetch, progress=1)
+
 
 class PushTestCase(unittest.TestCase):
     def setUp(self):
@@ -33,6 +33,7 @@ from __future__ import unicode_literals
 
 # Import from the Standard Library
 import binascii
+import shutil
 import unittest
 import tempfile
 import os
@@ -84,6 +85,26 @@ class RepositoryTest(utils.BareRepoTestCase):
         a3 = self.repo.read(a_hex_prefix)
         self.assertEqual((GIT_OBJ_BLOB, b'a contents\n'), a3)
 
+    def test_read_multi(self):
+        self.assertEqual([], self.repo.read_multi([]))
+        self.assertRaisesWithArg(KeyError, '1' * 40,
+                                 self.repo.read_multi, ['1' * 40])
+
+        a2_hex = '7f129fd57e31e935c6d60a0c794efe4e6927664b'
+        result = self.repo.read_multi([BLOB_OID, a2_hex, BLOB_HEX[:4]])
+        self.assertEqual(
+            [(BLOB_OID, GIT_OBJ_BLOB, b'a contents\n', 11),
+             (Oid(hex=a2_hex), GIT_OBJ_BLOB, b'a contents 2\n', 13),
+             (BLOB_OID, GIT_OBJ_BLOB, b'a contents\n', 11)],
+            result)
+
+        # Objects over max_size come back without their data
+        result = self.repo.read_multi([BLOB_OID, a2_hex], max_size=11)
+        self.assertEqual(
+            [(BLOB_OID, GIT_OBJ_BLOB, b'a contents\n', 11),
+             (Oid(hex=a2_hex), GIT_OBJ_BLOB, None, 13)],
+            result)
+
     def test_write(self):
         data = b"hello world"
         # invalid object type
@@ -128,6 +149,31 @@ class RepositoryTest(utils.BareRepoTestCase):
                           'This commit has some additional text.\n'),
                          commit.message)
 
+    def test_object_cache(self):
+        self.assertEqual(0, self.repo.object_cache_size)
+        self.assertFalse(self.repo[BLOB_HEX] is self.repo[BLOB_HEX])
+
+        self.repo.object_cache_size = 8
+        self.assertEqual(8, self.repo.object_cache_size)
+        self.assertTrue(self.repo[BLOB_HEX] is self.repo[BLOB_HEX])
+        self.assertTrue(self.repo[BLOB_OID] is self.repo[BLOB_HEX])
+        # Once the prefix is resolved the wrapper is shared too
+        self.assertTrue(self.repo[BLOB_HEX[:5]] is self.repo[BLOB_HEX])
+
+        # The cache is an identity map for every wrap path
+        commit = self.repo['5ebeeebb320790caf276b9fc8b24546d63316533']
+        self.assertTrue(commit.tree is commit.tree)
+        parent = commit.parents[0]
+        self.assertTrue(parent is self.repo[parent.hex])
+
+        self.repo.object_cache_size = 0
+        self.assertFalse(self.repo[BLOB_HEX] is self.repo[BLOB_HEX])
+
+        def set_size(value):
+            self.repo.object_cache_size = value
+        self.assertRaises(ValueError, set_size, -1)
+        self.assertRaises(TypeError, set_size, 'big')
+
     def test_lookup_commit_prefix(self):
         commit_sha = '5fe808e8953c12735680c257f56600cb0de44b10'
         commit_sha_prefix = commit_sha[:7]
@@ -153,6 +199,23 @@ class RepositoryTest(utils.BareRepoTestCase):
         parent = self.repo.revparse_single('HEAD^')
         self.assertEqual(parent.hex, PARENT_SHA)
 
+    def test_revparse_many(self):
+        objects = self.repo.revparse_many(['HEAD', 'HEAD^'])
+        self.assertEqual(objects[0].hex, HEAD_SHA)
+        self.assertEqual(objects[1].hex, PARENT_SHA)
+        self.assertRaises(KeyError, self.repo.revparse_many, ['no-such'])
+        self.assertRaises(TypeError, self.repo.revparse_many, 'HEAD')
+
+    def test_revparse_cache(self):
+        self.assertEqual(self.repo.revparse_cache_size, 0)
+        self.repo.revparse_cache_size = 8
+        self.assertEqual(self.repo.revparse_single('HEAD^').hex, PARENT_SHA)
+        # The second resolution is served from the cache
+        self.assertEqual(self.repo.revparse_single('HEAD^').hex, PARENT_SHA)
+        self.repo.invalidate_refs()
+        self.assertEqual(self.repo.revparse_single('HEAD^').hex, PARENT_SHA)
+        self.repo.revparse_cache_size = 0
+
     def test_hash(self):
         data = "foobarbaz"
         hashed_sha1 = pygit2.hash(data)
@@ -231,6 +294,18 @@ class RepositoryTest_II(utils.RepoTestCase):
         self.repo.checkout('HEAD', pygit2.GIT_CHECKOUT_FORCE)
         self.assertTrue('bye.txt' not in self.repo.status())
 
+    def test_checkout_progress(self):
+        ref_i18n = self.repo.lookup_reference('refs/heads/i18n')
+        calls = []
+        self.repo.checkout(ref_i18n, pygit2.GIT_CHECKOUT_FORCE,
+                           lambda *args: calls.append(args))
+        self.assertTrue(len(calls) > 0)
+        path, completed, total = calls[-1]
+        self.assertEqual(completed, total)
+
+        self.assertRaises(TypeError, self.repo.checkout_head,
+                          pygit2.GIT_CHECKOUT_FORCE, 'not-a-callable')
+
     def test_merge_base(self):
         commit = self.repo.merge_base(
             '5ebeeebb320790caf276b9fc8b24546d63316533',
@@ -238,6 +313,72 @@ class RepositoryTest_II(utils.RepoTestCase):
         self.assertEqual(commit.hex,
                          'acecd5ea2924a4b900e7e149496e1f4b57976e51')
 
+    def test_merge_base_many(self):
+        commit = self.repo.merge_base_many([
+            '5ebeeebb320790caf276b9fc8b24546d63316533',
+            '4ec4389a8068641da2d6578db0419484972284c8'])
+        self.assertEqual(commit.hex,
+                         'acecd5ea2924a4b900e7e149496e1f4b57976e51')
+        self.assertRaises(TypeError, self.repo.merge_base_many, 'not-a-list')
+
+    def test_packbuilder(self):
+        pack_dir = tempfile.mkdtemp()
+        try:
+            builder = self.repo.PackBuilder()
+            self.assertEqual(0, builder.object_count)
+            self.assertEqual(1, builder.set_threads(1))
+
+            builder.insert_commit(
+                '5ebeeebb320790caf276b9fc8b24546d63316533')
+            self.assertTrue(builder.object_count > 0)
+            self.assertEqual(0, builder.written)
+
+            builder.write(pack_dir)
+            self.assertEqual(builder.object_count, builder.written)
+            packs = [name for name in os.listdir(pack_dir)
+                     if name.endswith('.pack')]
+            self.assertEqual(1, len(packs))
+        finally:
+            shutil.rmtree(pack_dir)
+
+    def test_ahead_behind(self):
+        ahead, behind = self.repo.ahead_behind(
+            '5ebeeebb320790caf276b9fc8b24546d63316533',
+            '4ec4389a8068641da2d6578db0419484972284c8')
+        self.assertEqual(1, ahead)
+        self.assertEqual(2, behind)
+
+        ahead, behind = self.repo.ahead_behind(
+            '4ec4389a8068641da2d6578db0419484972284c8',
+            '5ebeeebb320790caf276b9fc8b24546d63316533')
+        self.assertEqual(2, ahead)
+        self.assertEqual(1, behind)
+
+
+class StatsTest(utils.BareRepoTestCase):
+
+    def test_stats(self):
+        # Counters do not advance while disabled
+        pygit2.reset_stats()
+        self.repo.read(BLOB_HEX)
+        calls, total = pygit2.get_stats()['Repository_read']
+        self.assertEqual(calls, 0)
+
+        pygit2.enable_stats(True)
+        try:
+            self.repo.read(BLOB_HEX)
+            self.repo.read(BLOB_HEX)
+        finally:
+            pygit2.enable_stats(False)
+
+        calls, total = pygit2.get_stats()['Repository_read']
+        self.assertEqual(calls, 2)
+        self.assertTrue(total >= 0.0)
+
+        pygit2.reset_stats()
+        calls, total = pygit2.get_stats()['Repository_read']
+        self.assertEqual(calls, 0)
+
 
 class NewRepositoryTest(utils.NoRepoTestCase):
 
@@ -97,6 +97,47 @@ class WalkerTest(utils.RepoTestCase):
         walker.push(log[0])
         self.assertEqual([x.hex for x in walker], log)
 
+    def test_push_many(self):
+        walker = self.repo.walk(log[-1], GIT_SORT_TIME)
+        walker.reset()
+        walker.push_many([log[0]])
+        self.assertEqual([x.hex for x in walker], log)
+        self.assertRaises(TypeError, walker.push_many, log[0])
+
+    def test_hide_many(self):
+        walker = self.repo.walk(log[0], GIT_SORT_TIME)
+        walker.hide_many(['4ec4389a8068641da2d6578db0419484972284c8'])
+        self.assertEqual(len(list(walker)), 2)
+
+    def test_skip(self):
+        walker = self.repo.walk(log[0], GIT_SORT_TIME)
+        self.assertEqual(walker.skip(3), 3)
+        self.assertEqual([x.hex for x in walker], log[3:])
+        self.assertEqual(walker.skip(10), 0)
+        self.assertRaises(ValueError, walker.skip, -1)
+
+    def test_next_batch(self):
+        walker = self.repo.walk(log[0], GIT_SORT_TIME)
+        batch = walker.next_batch(3)
+        self.assertEqual([x.hex for x in batch], log[:3])
+        batch = walker.next_batch(10)
+        self.assertEqual([x.hex for x in batch], log[3:])
+        self.assertEqual(walker.next_batch(10), [])
+
+    def test_records(self):
+        walker = self.repo.walk(log[0], GIT_SORT_TIME)
+        records = walker.records()
+        self.assertEqual(len(records), len(log))
+        for record, hex in zip(records, log):
+            commit = self.repo[hex]
+            oid, name, email, time, parents = record
+            self.assertEqual(oid.hex, hex)
+            self.assertEqual(name, commit.author.name)
+            self.assertEqual(email, commit.author.email)
+            self.assertEqual(time, commit.commit_time)
+            self.assertEqual(parents, len(commit.parents))
+        self.assertEqual(walker.records(), [])
+
     def test_sort(self):
         walker = self.repo.walk(log[0], GIT_SORT_TIME)
         walker.sort(GIT_SORT_TIME | GIT_SORT_REVERSE)
@@ -64,6 +64,12 @@ class SignatureTest(NoRepoTestCase):
         self.assertEqual(signature.email.encode(encoding),
                          signature.raw_email)
 
+    def test_decode_cached(self):
+        signature = Signature('Foo', 'foo@example.com', 1322174594, 60)
+        # The decoded strings are built once and kept on the wrapper
+        self.assertTrue(signature.name is signature.name)
+        self.assertTrue(signature.email is signature.email)
+
     def test_now(self):
         encoding = 'utf-8'
         signature = Signature(
@@ -46,6 +46,50 @@ class StatusTest(utils.DirtyRepoTestCase):
             self.assertTrue(filepath in git_status)
             self.assertEqual(status, git_status[filepath])
 
+    def test_status_paths(self):
+        """
+        Only the files matching the given pathspecs are scanned.
+        """
+        full_status = self.repo.status()
+        git_status = self.repo.status(paths=['subdir'])
+        self.assertTrue(len(git_status) > 0)
+        for filepath, status in git_status.items():
+            self.assertTrue(filepath.startswith('subdir/'))
+            self.assertEqual(status, full_status[filepath])
+
+    def test_status_untracked(self):
+        """
+        Untracked files are skipped when untracked is False.
+        """
+        git_status = self.repo.status(untracked=False)
+        for filepath, status in git_status.items():
+            self.assertFalse(status & pygit2.GIT_STATUS_WT_NEW)
+
+    def test_status_files(self):
+        """
+        One batch call matches status_file() for every path.
+        """
+        full_status = self.repo.status()
+        paths = list(full_status.keys()) + ['current_file']
+        git_status = self.repo.status_files(paths)
+        self.assertEqual(sorted(paths), sorted(git_status.keys()))
+        for filepath in paths:
+            self.assertEqual(self.repo.status_file(filepath),
+                             git_status[filepath])
+        self.assertRaises(TypeError, self.repo.status_files, 'not-a-list')
+
+    def test_is_dirty(self):
+        self.assertTrue(self.repo.is_dirty())
+        self.assertTrue(self.repo.is_dirty(untracked=False))
+
+
+class CleanStatusTest(utils.RepoTestCase):
+
+    def test_is_dirty(self):
+        # The testrepo worktree is clean except for one untracked file
+        self.assertTrue(self.repo.is_dirty())
+        self.assertFalse(self.repo.is_dirty(untracked=False))
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -89,6 +89,18 @@ class TagTest(utils.BareRepoTestCase):
         self.assertRaises(AttributeError, setattr, tag, 'tagger', tagger)
         self.assertRaises(AttributeError, setattr, tag, 'message', message)
 
+    def test_peel(self):
+        repo = self.repo
+        tag = repo[TAG_SHA]
+        commit = tag.peel(pygit2.GIT_OBJ_COMMIT)
+        self.assertEqual(pygit2.GIT_OBJ_COMMIT, commit.type)
+        self.assertEqual(repo[tag.target].oid, commit.oid)
+        tree = tag.peel(pygit2.GIT_OBJ_TREE)
+        self.assertEqual(pygit2.GIT_OBJ_TREE, tree.type)
+        self.assertEqual(commit.tree.oid, tree.oid)
+        self.assertEqual(commit.oid,
+                         repo.peel(TAG_SHA, pygit2.GIT_OBJ_COMMIT).oid)
+
     def test_get_object(self):
         repo = self.repo
         tag = repo[TAG_SHA]
@@ -83,6 +83,24 @@ class TreeTest(utils.BareRepoTestCase):
         self.assertTreeEntryEqual(subtree[0], sha, 'd', 0o0100644)
 
 
+    def test_walk_preorder(self):
+        tree = self.repo[TREE_SHA]
+        entries = tree.walk_preorder()
+        self.assertEqual(
+            ['a', 'b', 'c', 'c/d'],
+            [path for path, oid, filemode in entries])
+
+        for path, oid, filemode in entries:
+            entry = tree[path]
+            self.assertEqual(entry.oid, oid)
+            self.assertEqual(entry.filemode, filemode)
+
+
+    def test_name_interned(self):
+        tree = self.repo[TREE_SHA]
+        # Repeated materialization of the same name shares one object
+        self.assertTrue(tree[0].name is tree[0].name)
+
     def test_new_tree(self):
         repo = self.repo
         b0 = repo.create_blob('1')
@@ -104,6 +122,22 @@ class TreeTest(utils.BareRepoTestCase):
         self.assertEqual(repo[y.oid].oid, b1)
 
 
+    def test_insert_many(self):
+        repo = self.repo
+        b0 = repo.create_blob('1')
+        b1 = repo.create_blob('2')
+        t = repo.TreeBuilder()
+        t.insert_many([('x', b0, 0o0100644), ('y', b1, 0o0100755)])
+        self.assertEqual(2, len(t))
+        tree = repo[t.write()]
+
+        self.assertEqual(tree['x'].oid, b0)
+        self.assertEqual(tree['y'].oid, b1)
+        self.assertEqual(tree['y'].filemode, 0o0100755)
+
+        self.assertRaises(TypeError, t.insert_many, [('x', b0)])
+        self.assertRaises(TypeError, t.insert_many, ['x'])
+
     def test_modify_tree(self):
         tree = self.repo[TREE_SHA]
         self.assertRaises(TypeError, operator.setitem, 'c', tree['a'])